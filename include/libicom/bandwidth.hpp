@@ -0,0 +1,134 @@
+/*!
+ * @file       bandwidth.hpp
+ * @brief      Declares the Icom::Budget and Icom::Utilization classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BANDWIDTH_HPP
+#define BANDWIDTH_HPP
+
+#include "libicom/command.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Token bucket budget of bus time
+    /*!
+     * Tokens are measured in time on the wire and refill at a fixed share of
+     * real time up to a burst limit. Spending is allowed to run the budget
+     * into debt since the size of a reply isn't known until it arrives. Once
+     * in debt nothing more may be sent until the debt has been refilled.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Budget
+    {
+    public:
+        //! Sole constructor
+        /*!
+         * The budget starts out full.
+         *
+         * @param   [in] share Fraction of bus time allowed on average
+         * @param   [in] burst Most bus time that can be saved up
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Budget(const double share, const Clock::duration burst);
+
+        //! When will the budget be out of debt?
+        /*!
+         * @return  Earliest time something may be sent. In the past if
+         *          something may be sent now.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point available() const;
+
+        //! Spend bus time from the budget
+        /*!
+         * @param   [in] cost Time on the wire to spend
+         * @param   [in] now Current time
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void spend(const Clock::duration cost, const Clock::time_point now);
+
+    private:
+        const double m_share;  //!< Fraction of real time refilled
+        const Clock::duration m_burst;  //!< Most tokens we can hold
+        Clock::duration m_tokens;  //!< Tokens held as of m_last
+        Clock::time_point m_last;  //!< Time m_tokens was last updated
+    };
+
+    //! Sliding window measurement of bus utilization
+    /*!
+     * Time on the wire is accumulated into fixed windows. The utilization is
+     * estimated from the current window and the overlapping part of the
+     * previous one.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Utilization
+    {
+    public:
+        //! Sole constructor
+        /*!
+         * @param   [in] window Length of the measurement window
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Utilization(const Clock::duration window);
+
+        //! Record time spent on the wire
+        /*!
+         * @param   [in] busy Time on the wire
+         * @param   [in] now Current time
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void add(const Clock::duration busy, const Clock::time_point now);
+
+        //! Fraction of the last window that the bus was busy
+        /*!
+         * @param   [in] now Current time
+         * @return  Utilization from zero to one
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double value(const Clock::time_point now);
+
+    private:
+        //! Move the windows forward to now
+        void advance(const Clock::time_point now);
+
+        const Clock::duration m_window;  //!< Length of a window
+        Clock::time_point m_start;  //!< Start of the current window
+        Clock::duration m_current;  //!< Busy time in the current window
+        Clock::duration m_previous;  //!< Busy time in the previous window
+    };
+}
+
+#endif
@@ -0,0 +1,220 @@
+/*!
+ * @file       bcd.hpp
+ * @brief      Declares functions for handling binary coded decimal
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       September 8, 2015
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BCD_HPP
+#define BCD_HPP
+
+#include "libicom/command.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Validate 16 packed BCD digits at once
+    /*!
+     * A nibble is greater than nine only if bit 3 and one of bits 1 or 2 are
+     * set.
+     *
+     * @param   [in] packed Packed BCD digits. Least significant digit first.
+     * @return  True if every nibble is a decimal digit.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    constexpr bool validBCD(const uint64_t packed)
+    {
+        return !(packed & ((packed<<1) | (packed<<2)) & 0x8888888888888888ULL);
+    }
+
+    //! Implementation details of the compile time %BCD codec
+    namespace BCD
+    {
+        //! Add each odd lane, scaled, to the even lane below it
+        constexpr uint64_t merge(
+                const uint64_t lanes,
+                const unsigned int width,
+                const uint64_t mask,
+                const uint64_t scale)
+        {
+            return (lanes & mask) + ((lanes>>width) & mask)*scale;
+        }
+
+        //! Replace each lane with a remainder/quotient pair of sub-lanes
+        constexpr uint64_t split(
+                const uint64_t lanes,
+                const uint64_t quotients,
+                const unsigned int width,
+                const uint64_t divisor)
+        {
+            return (lanes - quotients*divisor) | quotients<<width;
+        }
+
+        //! Squeeze every other lane down into the one below it
+        constexpr uint64_t compress(
+                const uint64_t lanes,
+                const unsigned int width,
+                const uint64_t mask)
+        {
+            return (lanes | lanes>>width) & mask;
+        }
+
+        //! Split two 32 bit lanes less than 10^4 by 100
+        /*!
+         * (x*5243)>>19 is exact for x < 43699 and the product fits in the
+         * lane.
+         */
+        constexpr uint64_t split100(const uint64_t lanes)
+        {
+            return split(
+                    lanes,
+                    ((lanes*5243)>>19) & 0x0000007f0000007fULL,
+                    16,
+                    100);
+        }
+
+        //! Split four 16 bit lanes less than 100 by 10
+        /*!
+         * (x*103)>>10 is exact for x < 179 and the product fits in the lane.
+         */
+        constexpr uint64_t split10(const uint64_t lanes)
+        {
+            return split(
+                    lanes,
+                    ((lanes*103)>>10) & 0x000f000f000f000fULL,
+                    8,
+                    10);
+        }
+
+        //! Convert a number less than 10^8 into 8 packed BCD digits
+        constexpr uint64_t pack8(const uint64_t number)
+        {
+            return compress(compress(compress(
+                            split10(split100(
+                                    (number%10000) | (number/10000)<<32)),
+                            4, 0x00ff00ff00ff00ffULL),
+                        8, 0x0000ffff0000ffffULL),
+                    16, 0x00000000ffffffffULL);
+        }
+    }
+
+    //! Convert 16 packed BCD digits into binary
+    /*!
+     * Neighbouring lanes are combined in parallel so that each step doubles
+     * the lane width: digits, then pairs, quads and finally octets. The
+     * result is meaningless unless validBCD() is true for the input.
+     *
+     * @param   [in] packed Packed BCD digits. Least significant digit first.
+     * @return  Binary representation of the digits.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    constexpr uint64_t unpackBCD(const uint64_t packed)
+    {
+        return BCD::merge(BCD::merge(BCD::merge(BCD::merge(
+                            packed, 4, 0x0f0f0f0f0f0f0f0fULL, 10),
+                        8, 0x00ff00ff00ff00ffULL, 100),
+                    16, 0x0000ffff0000ffffULL, 10000),
+                32, 0x00000000ffffffffULL, 100000000);
+    }
+
+    //! Convert a number into 16 packed BCD digits
+    /*!
+     * This is the reverse of unpackBCD(). Each lane is split in two by
+     * multiplying with a fixed point reciprocal that is exact over the lane's
+     * range. Only the 16 least significant digits are kept.
+     *
+     * @param   [in] number Number to convert.
+     * @return  Packed BCD digits. Least significant digit first.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    constexpr uint64_t packBCD(const uint64_t number)
+    {
+        return BCD::pack8(number%100000000)
+            | BCD::pack8((number/100000000)%100000000)<<32;
+    }
+
+    //! Load up to 8 bytes of packed BCD digits from raw memory
+    /*!
+     * @param   [in] data Pointer to the first (least significant) byte.
+     * @param   [in] size Number of bytes to load. Must not exceed 8.
+     * @return  Packed BCD digits suitable for validBCD() and unpackBCD().
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    constexpr uint64_t loadBCD(const uint8_t* const data, const size_t size)
+    {
+        return size ? (uint64_t)*data | loadBCD(data+1, size-1)<<8 : 0;
+    }
+
+    //! Retrieve a single byte from packed BCD digits
+    /*!
+     * @param   [in] packed Packed BCD digits as returned by packBCD().
+     * @param   [in] index Byte to retrieve. Byte zero is least significant.
+     * @return  The requested byte. Zero if index is past the eighth byte.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    constexpr uint8_t bcdByte(const uint64_t packed, const size_t index)
+    {
+        return index<sizeof(uint64_t) ? (uint8_t)(packed >> 8*index) : 0;
+    }
+
+    //! Extract a binary coded decimal number from a string of bytes
+    /*!
+     * All nibbles are decoded and validated at once so at most 8 bytes (16
+     * digits) can be extracted.
+     *
+     * @param   [in] start Iterator to the start of the data
+     * @param   [in] end Iterator to the end of the data
+     * @param   [out] number Extracted number. Only valid if we return true.
+     * @return  False if the data is too long or contains a nibble greater than
+     *          nine.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    bool getBCD(
+            const Buffer::const_iterator start,
+            const Buffer::const_iterator end,
+            uint64_t& number);
+
+    //! Insert a binary coded decimal number into a string of bytes
+    /*!
+     * Only the 16 least significant digits are encoded. Any bytes beyond the
+     * eighth are zeroed.
+     *
+     * @param   [out] start Iterator to data start
+     * @param   [out] start Iterator to data end
+     * @param   [in] number Number to convert to %BCD
+     * @date    September 4, 2015
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    void putBCD(
+            const Buffer::iterator start,
+            const Buffer::iterator end,
+            uint64_t number);
+}
+
+#endif
@@ -0,0 +1,189 @@
+/*!
+ * @file       busowner.hpp
+ * @brief      Declares the Icom::BusOwner class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUSOWNER_HPP
+#define BUSOWNER_HPP
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "libicom/controller.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Single thread owning the bus that commands are submitted to
+    /*!
+     * Any number of threads can submit commands. Submission only pushes the
+     * command onto a lock free queue and so never waits on the bus or on
+     * another submitter. The owning thread takes everything that has been
+     * submitted, runs it on the bus in bursts as in
+     * Controller::execute(Commands&), and completes each command's future as
+     * soon as that command is done.
+     *
+     * Since submitted commands can be sent in the same burst, none of them
+     * may depend on the outcome of another that hasn't completed.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class BusOwner
+    {
+    public:
+        //! Start the owning thread
+        /*!
+         * @param   [in] controller Controller of the bus. It may still be
+         *          used directly by other threads.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        BusOwner(const Controller& controller);
+
+        //! Finish everything submitted and stop the owning thread
+        ~BusOwner();
+
+        //! Submit a command to be run
+        /*!
+         * The command must not be touched until the future is ready.
+         *
+         * @param   [in] command The Command to run
+         * @return  Future that becomes ready once the command has completed.
+         *          Any exception thrown while running it is passed on
+         *          through this.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        std::future<void> submit(const Command& command);
+
+        //! Synchronously execute a command
+        /*!
+         * @param   [inout] command The Command to execute.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void execute(const Command& command)
+        {
+            submit(command).get();
+        }
+
+        //! Pin the owning thread to a CPU
+        /*!
+         * Keeping the thread on a CPU of its own, ideally one isolated from
+         * the scheduler, keeps it from being moved or crowded out.
+         *
+         * @param   [in] cpu Index of the CPU to run on
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void setAffinity(const unsigned int cpu);
+
+        //! Run the owning thread with real time priority
+        /*!
+         * The thread is switched to the SCHED_FIFO policy so it runs ahead
+         * of all normal threads as soon as it wakes. This usually needs
+         * CAP_SYS_NICE.
+         *
+         * @param   [in] priority SCHED_FIFO priority from 1 to 99
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void setRealtime(const int priority);
+
+        //! Lock all memory of the process into RAM
+        /*!
+         * This keeps page faults out of the bus timing. It applies to the
+         * whole process, current and future allocations alike.
+         *
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static void lockMemory();
+
+        //! Error indicating failure to tune the owning thread
+        class CantTuneThread: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to tune the bus owner thread.";
+            }
+        };
+
+        //! Error indicating failure to create the wakeup descriptor
+        class CantCreateWakeup: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to create wakeup file descriptor.";
+            }
+        };
+
+    private:
+        //! A submitted command in the queue
+        struct Node
+        {
+            Command command;  //!< The command to run
+            std::promise<void> done;  //!< Completed when the command is
+            std::atomic<Node*> next;  //!< Next node towards the head
+
+            Node(): next(nullptr) {}
+        };
+
+        //! Add a node to the head of the queue. Safe from any thread.
+        void push(Node* node);
+
+        //! Take a node from the tail of the queue. Owning thread only.
+        /*!
+         * @return  Oldest node or nullptr if there is none. This may return
+         *          nullptr while a push is half way done but the pushing
+         *          thread wakes us once it finishes.
+         */
+        Node* pop();
+
+        //! Body of the owning thread
+        void run();
+
+        //! Make the owning thread look for work
+        void wake();
+
+        const Controller& m_controller;  //!< Controller of the bus
+
+        std::atomic<Node*> m_head;  //!< Most recently pushed node
+        Node* m_tail;  //!< Next node to pop. Owning thread only.
+        Node m_stub;  //!< Placeholder keeping the queue non-empty
+
+        int m_wake;  //!< Event descriptor readable when there is work
+        std::atomic<bool> m_running;  //!< Cleared to stop the thread
+
+        std::thread m_thread;  //!< The owning thread
+
+        BusOwner(const BusOwner&);
+        BusOwner& operator=(const BusOwner&);
+    };
+}
+
+#endif
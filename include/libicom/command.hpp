@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <memory>
+#include <chrono>
 
 #include "libicom/device.hpp"
 
@@ -40,7 +41,23 @@ namespace Icom
     typedef std::vector<uint8_t> Buffer;
 
     //! Enumeration for indicating command status
-    enum Status {INCOMPLETE, FAIL, PARSEERROR, SUCCESS};
+    enum Status {INCOMPLETE, FAIL, PARSEERROR, SUCCESS, TIMEOUT};
+
+    //! Enumeration for indicating how urgently a command should be run
+    /*!
+     * Lower values are more urgent.
+     */
+    enum priority_t: uint8_t
+    {
+        INTERACTIVE = 0x00,  //!< Direct control of the device
+        NORMAL      = 0x01,  //!< Anything in between
+        BACKGROUND  = 0x02   //!< Telemetry and polling
+    };
+
+    //! Clock used for all command timing
+    typedef std::chrono::steady_clock Clock;
+
+    struct RadioState;
 
     //! Base class for handling %Icom CI-V commands
     /*!
@@ -83,10 +100,249 @@ namespace Icom
          */
         Status status() const { return m_status; }
 
+        //! How urgently should this command be run?
+        /*!
+         * @return  Priority class of the command
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        priority_t priority() const { return m_priority; }
+
+        //! Override the default priority of the command
+        /*!
+         * Reads default to BACKGROUND and everything else to INTERACTIVE.
+         *
+         * @param   [in] priority New priority class of the command
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void setPriority(const priority_t priority) { m_priority = priority; }
+
+        //! Which client submitted this command?
+        /*!
+         * The Controller can limit the bus time used by each client.
+         *
+         * @return  Client identifier. Zero by default.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        unsigned int client() const { return m_client; }
+
+        //! Attribute this command to a client
+        /*!
+         * @param   [in] client Client identifier
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void setClient(const unsigned int client) { m_client = client; }
+
+        //! Does this command only read from the device?
+        /*!
+         * Read only commands have no effect on the device so identical ones
+         * can safely share a single exchange.
+         *
+         * @return  True if the command only reads from the device.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        virtual bool readOnly() const { return false; }
+
+        //! Earliest time the next exchange may be sent
+        /*!
+         * Commands that poll the device set this in between exchanges so
+         * that the Controller can wait without occupying the bus.
+         *
+         * @return  Time the command is next due. The default constructed
+         *          time point means immediately.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point due() const { return m_due; }
+
+        //! Request the command hit the wire at a specific time
+        /*!
+         * The command won't be sent before the target and the Controller
+         * gives the bus to the timed command with the earliest target ahead
+         * of any priority. Whether it made it on time can be checked with
+         * jitter() once it has been executed.
+         *
+         * @param   [in] target Time the first frame should be sent at
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void setTarget(const Clock::time_point target)
+        {
+            m_target = target;
+            m_due = target;
+        }
+
+        //! Time the command was requested to hit the wire at
+        /*!
+         * @return  Target time. The maximum time point if not timed.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point target() const { return m_target; }
+
+        //! Was the command given a target time?
+        /*!
+         * @return  True if setTarget() has been called.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool timed() const { return m_target != Clock::time_point::max(); }
+
+        //! Time the first frame of the command was sent
+        /*!
+         * @return  Time of sending. The default constructed time point if
+         *          nothing has been sent.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point sent() const { return m_sent; }
+
+        //! How far off target was the command sent?
+        /*!
+         * @return  Time the first frame was sent minus the target time.
+         *          Positive if late. Only meaningful for timed commands that
+         *          have been sent.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::duration jitter() const { return m_sent-m_target; }
+
+        //! Record that a frame of the command has been sent
+        /*!
+         * The Controller calls this as each frame is written. Only the first
+         * is remembered.
+         *
+         * @param   [in] time Time the frame was written
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void transmitted(const Clock::time_point time)
+        {
+            if(m_sent == Clock::time_point())
+                m_sent = time;
+        }
+
+        //! Prepare the command to be executed again
+        /*!
+         * Clears the status, result and time of sending so the same command
+         * can be executed repeatedly without being rebuilt. The target time
+         * and priority are kept.
+         *
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void reset();
+
+        //! Give up waiting for the reply to the command
+        /*!
+         * The Controller calls this once a device has been silent too long.
+         * The status becomes TIMEOUT.
+         *
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void abandon() { m_status = TIMEOUT; }
+
+        //! Don't wait for the device to acknowledge the command
+        /*!
+         * The command is considered a SUCCESS as soon as it has been sent
+         * and the acknowledgement is discarded whenever it turns up. Should
+         * it turn out to be a failure it is counted in
+         * Controller::rejections(). This only has an effect on commands that
+         * set something and should only be used on commands of a single
+         * exchange. The outcome can be verified later with a Verifier.
+         *
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void skipAcknowledgement() { m_skipAcknowledgement = true; }
+
+        //! Does the Controller need to wait for a reply to this command?
+        /*!
+         * @return  False if the command expects no reply or its
+         *          acknowledgement is being skipped.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool awaitsReply() const
+        {
+            return m_reply && (!m_skipAcknowledgement || readOnly());
+        }
+
+        //! Pass on a frame broadcast by the device
+        /*!
+         * With transceive enabled the device broadcasts changes made on its
+         * front panel. Any such frame seen by the Controller while this
+         * command is pending is passed on here. The default is to ignore it.
+         *
+         * @param   [in] data Frame contents between the addresses and footer
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        virtual void transceive(const Buffer& /*data*/) {}
+
+        //! Record the outcome of the command in the device state
+        /*!
+         * The Controller calls this once the command has completed
+         * successfully. Commands that set or read part of the device state
+         * should record it here.
+         *
+         * @param   [inout] state Cached state of our device
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        virtual void update(RadioState& /*state*/) const {}
+
+        //! Complete the command from the device state
+        /*!
+         * If the Controller is caching reads, it calls this before sending
+         * anything. Read commands that can be answered from the cached
+         * device state should fill in their result, set the status to
+         * SUCCESS and return true.
+         *
+         * @param   [in] state Cached state of our device
+         * @param   [in] maxAge Oldest a cached value may be to be used
+         * @return  True if the command was completed without the device.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        virtual bool recall(
+                const RadioState& /*state*/,
+                const Clock::duration /*maxAge*/)
+        {
+            return false;
+        }
+
+        //! Skip the command if the device state already matches
+        /*!
+         * If the Controller is suppressing redundant sets, it calls this
+         * before sending anything. Set commands whose value matches the
+         * cached device state should set the status to SUCCESS and return
+         * true. Only values the device has confirmed count (see
+         * Known::confirmed()). A value we only sent may never have arrived.
+         *
+         * @param   [in] state Cached state of our device
+         * @param   [in] maxAge Oldest a cached value may be to be trusted
+         * @return  True if the command was completed without the device.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        virtual bool suppress(
+                const RadioState& /*state*/,
+                const Clock::duration /*maxAge*/)
+        {
+            return false;
+        }
+
         virtual ~Command_base() {}
 
         static const uint8_t footer=0xfd;  //!< Byte indicating message end
         static const uint8_t header=0xfe;  //!< Byte indicating message start
+        static const uint8_t broadcast=0x00;  //!< Address of all devices
         static const size_t bufferReserveSize=64;  //!< Size of command/result buffer reserve
         const device_t device;  //!< Target %Icom device
 
@@ -118,8 +374,13 @@ namespace Icom
          * of this being useful is for polling the squelch status of the
          * receiver and not being "done" until it is either open or close.
          *
+         * The Controller gives up the bus between such executions so other
+         * commands can be run in between. Set m_due to hold off the next
+         * execution and load new data into m_command if the next exchange
+         * differs from the last.
+         *
          * @return  "false" if command should be run again. "true" otherwise.
-         * @date    September 4, 2015
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
         virtual bool subcomplete() { return true; }
@@ -128,18 +389,33 @@ namespace Icom
         /*!
          * @param   [in] dev The %Icom %device_t in question
          * @param   [in] reply Should we expect a reply?
-         * @date    September 8, 2015
+         * @param   [in] priority Default priority class of the command
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
-        Command_base(const device_t& dev, bool reply=true);
+        Command_base(
+                const device_t& dev,
+                bool reply=true,
+                priority_t priority=INTERACTIVE);
 
         Status m_status;   //!< Current status of command
         Buffer m_command;  //!< Buffer with command data
         Buffer m_result;   //!< Buffer with command result
+        Clock::time_point m_due;  //!< Earliest time of next exchange
+        priority_t m_priority;  //!< How urgently to run the command
+        unsigned int m_client;  //!< Client the command is attributed to
+
+    private:
+        Clock::time_point m_target;  //!< Requested time of first frame
+        Clock::time_point m_sent;  //!< Actual time of first frame
+        bool m_skipAcknowledgement;  //!< Don't wait for the acknowledgement
     };
 
     //! Shared pointer holder for commands.
     typedef std::shared_ptr<Command_base> Command;
+
+    //! Container type for batches of commands
+    typedef std::vector<Command> Commands;
 }
 
 #endif
@@ -29,15 +29,39 @@
 #define CONTROLLER_HPP
 
 #include <exception>
+#include <algorithm>
 #include <string>
+#include <map>
+#include <deque>
+#include <limits>
+#include <array>
+#include <tuple>
+#include <mutex>
+#include <condition_variable>
 
 #include "libicom/command.hpp"
+#include "libicom/state.hpp"
+#include "libicom/scheduler.hpp"
+#include "libicom/bandwidth.hpp"
+#include "libicom/uring.hpp"
 
 //! Contains all elements for controlling %Icom devices
 namespace Icom
 {
     //! Class for representing an %Icom CI-V controller
     /*!
+     * All member functions are safe to call from multiple threads. Commands
+     * are run on the bus one at a time. Identical read commands from the same
+     * client that are in flight at the same time share a single exchange.
+     * When several threads want the bus it goes to the most urgent command by
+     * priority_t, with waiting commands gradually promoted so none are
+     * starved. Timed commands (see Command_base::setTarget()) go ahead of
+     * everything, earliest target first.
+     *
+     * Every frame on the bus is costed by its time on the wire. Clients and
+     * devices can each be limited to a share of the bus so that a runaway
+     * poller can't crowd out control traffic.
+     *
      * @date    September 8, 2015
      * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
      */
@@ -61,10 +85,301 @@ namespace Icom
          * This returns once the command has completed its execution. The
          * commands result and status are set following this.
          *
+         * If another thread is already executing a read command with the
+         * same device and command data, we wait for its reply and parse
+         * that instead of asking the device again.
+         *
          * @param   [inout] command The Command to execute.
          */
         void execute(Command& command) const;
 
+        //! Synchronously execute a batch of independent commands
+        /*!
+         * The command data of every command in the batch is written to the
+         * bus back to back and the replies are then matched to the commands
+         * in order. Commands needing further exchanges are run again in the
+         * next burst. This returns once all commands have completed.
+         *
+         * Since all frames are sent before any reply is seen, no command in
+         * the batch may depend on the outcome of another. Commands that aren't
+         * due yet (see Command_base::due()) are held back until they are, so
+         * a polling command can wait alongside the others without holding
+         * them up.
+         *
+         * @param   [inout] commands The batch of commands to execute.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void execute(Commands& commands) const;
+
+        //! Execute a sequence of commands without interruption
+        /*!
+         * The bus is held from the first frame of the sequence until the
+         * last command has completed so no other command can get in between.
+         * The budgets are only consulted once, before the bus is taken. After
+         * that all of the commands are sent in order in a single burst and
+         * the whole sequence is charged as it goes. Commands needing further
+         * exchanges are run in further bursts, still without giving up the
+         * bus.
+         *
+         * No step is answered or suppressed from the cached state of the
+         * device since earlier steps may change it. Every step goes to the
+         * device.
+         *
+         * The device handles the frames in order so a step may depend on
+         * the device state left by earlier steps, such as the selected %VFO.
+         * It can't depend on the reply to one though. Every step is sent
+         * regardless of whether earlier steps succeed so the status of each
+         * should be checked.
+         *
+         * @param   [inout] steps The commands to execute in order
+         * @return  True if every step succeeded.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool transact(Commands& steps) const;
+
+        //! Execute a single exchange of a command
+        /*!
+         * This sends the currently loaded command data, waits for the reply
+         * (if any) and lets the command process it. Commands needing multiple
+         * exchanges because they poll need this called repeatedly until it
+         * returns true. Exchanges of other commands can be run in between.
+         *
+         * If the command isn't due yet this waits until it is before sending.
+         *
+         * @param   [inout] command The Command to advance.
+         * @return  True if the command has completed.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool step(Command& command) const;
+
+        //! Advance a changing set of commands by one burst
+        /*!
+         * This is for a thread that owns the bus and feeds it commands as
+         * they arrive (see BusOwner). Commands that can be completed from the
+         * cached device state or are due are completed or advanced as in
+         * execute(Commands&). Timed commands are left alone until it is time
+         * to claim the bus for them.
+         *
+         * The wait for commands to fall due is cut short as soon as the wake
+         * file descriptor becomes readable so new arrivals can be added.
+         *
+         * @param   [inout] pending Commands yet to complete
+         * @param   [out] completed Commands that have completed are moved
+         *          from pending to the end of this.
+         * @param   [in] wake File descriptor that becomes readable when there
+         *          is more work. Negative for none.
+         * @return  Time this should next be called at. It should be called
+         *          sooner if there is more work.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point step(
+                Commands& pending,
+                Commands& completed,
+                const int wake=-1) const;
+
+        //! Answer reads from the cached device state
+        /*!
+         * The Controller always keeps track of the last known state of each
+         * device from the commands it runs and the transceive frames it
+         * sees. With this enabled, read commands whose value is known and no
+         * older than maxAge are completed from that state without touching
+         * the bus.
+         *
+         * @param   [in] maxAge Oldest a cached value may be to be used. Zero
+         *          disables local reads.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void cacheReads(const Clock::duration maxAge)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxAge = maxAge;
+        }
+
+        //! Skip sets that match the cached device state
+        /*!
+         * With this enabled, SetFrequency, SetMode and %VFO selection
+         * commands that match the last known device state, as long as it is
+         * no older than maxAge, are completed successfully without touching
+         * the bus.
+         *
+         * @param   [in] maxAge Oldest a cached value may be to be trusted.
+         *          Zero disables suppression.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void suppressRedundant(const Clock::duration maxAge)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_suppressAge = maxAge;
+        }
+
+        //! Set how quickly waiting commands are promoted
+        /*!
+         * A command waiting for the bus is treated as one priority class
+         * more urgent for every multiple of this duration it has waited.
+         *
+         * @param   [in] promotion Wait time per class of promotion
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void promoteAfter(const Clock::duration promotion)
+        {
+            m_scheduler.promoteAfter(promotion);
+        }
+
+        //! Set how far ahead of its target a timed command claims the bus
+        /*!
+         * Frames can't be interrupted so a timed command has to take the bus
+         * before its target and hold it until then. This should be at least
+         * as long as the slowest exchange on the bus.
+         *
+         * @param   [in] lead Time before target to claim the bus at
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void claimBusAhead(const Clock::duration lead)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lead = lead;
+        }
+
+        //! Limit the bus time used by a client
+        /*!
+         * Commands from the client won't be sent while its budget is in
+         * debt. Both the command and reply frames are charged.
+         *
+         * @param   [in] client Client identifier as in
+         *          Command_base::setClient()
+         * @param   [in] share Fraction of bus time allowed on average. One
+         *          or more removes the limit. Must be more than zero.
+         * @param   [in] burst Most bus time that can be saved up
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void limitClient(
+                const unsigned int client,
+                const double share,
+                const Clock::duration burst);
+
+        //! Limit the bus time used by a device
+        /*!
+         * @param   [in] device The %Icom device in question
+         * @param   [in] share Fraction of bus time allowed on average. One
+         *          or more removes the limit. Must be more than zero.
+         * @param   [in] burst Most bus time that can be saved up
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void limitDevice(
+                const device_t& device,
+                const double share,
+                const Clock::duration burst);
+
+        //! Number of skipped acknowledgements that turned out to be failures
+        /*!
+         * Commands told to skip their acknowledgement are a SUCCESS as soon
+         * as they are sent. If the device then rejects one it is counted
+         * here.
+         *
+         * @return  Rejections since the Controller was made
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        unsigned long rejections() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_rejections;
+        }
+
+        //! Fraction of the last second the bus was busy
+        /*!
+         * This counts all frames seen on the bus, including transceive
+         * broadcasts, but not the echo of our own frames.
+         *
+         * @return  Utilization from zero to one
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double utilization() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_utilization.value(Clock::now());
+        }
+
+        //! Time on the wire of a number of bytes
+        /*!
+         * Each byte is ten bits with the start and stop bits.
+         *
+         * @param   [in] bytes Number of bytes
+         * @return  Time taken to send them at our baud rate
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::duration wireTime(const size_t bytes) const
+        {
+            return std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(bytes*10.0/m_baudRate));
+        }
+
+        //! Earliest time a client's budgets allow it to send to a device
+        /*!
+         * Callers that compute what to send at the last moment can wait
+         * this out first so that their data isn't stale by the time it hits
+         * the wire.
+         *
+         * @param   [in] device The %Icom device to send to
+         * @param   [in] client Client sending
+         * @return  Time the budgets allow sending. In the past if now.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::time_point available(
+                const device_t& device,
+                const unsigned int client=0) const
+        {
+            return ready(client, device.address);
+        }
+
+        //! Write a pre-encoded SetFrequency frame to the bus
+        /*!
+         * This is for hopping through a FrequencyPlan as quickly as
+         * possible. The frame is written as is, so nothing is encoded and no
+         * command is built, but it is still subject to the scheduling and
+         * budgets of the bus and the cached state of the device is updated.
+         * The acknowledgement isn't waited for. It is skipped when it turns
+         * up ahead of a later reply, like that of any command executed with
+         * a batch. A frame that isn't addressed from us or doesn't hold a
+         * valid frequency throws InvalidFrame without being sent.
+         *
+         * @param   [in] frame Complete frame as stored in a FrequencyPlan
+         * @param   [in] priority How urgently to send the frame
+         * @param   [in] client Client to attribute the frame to
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void hop(
+                const uint8_t* frame,
+                const priority_t priority=INTERACTIVE,
+                const unsigned int client=0) const;
+
+        //! Retrieve the last known state of a device
+        /*!
+         * @param   [in] device The %Icom device in question
+         * @return  Copy of the cached device state
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        RadioState state(const device_t& device) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_states[device.address];
+        }
+
         //! Error indicating failure to open serial port
         class CantOpenPort: public std::exception
         {
@@ -92,6 +407,15 @@ namespace Icom
             }
         };
 
+        //! Error indicating that we've been passed a share of zero or less
+        class InvalidShare: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Invalid bus time share.";
+            }
+        };
+
         //! Error indicating that we've received an invalid reply over the CI-V bus
         class InvalidReply: public std::exception
         {
@@ -101,6 +425,15 @@ namespace Icom
             }
         };
 
+        //! Error indicating that a pre-encoded frame isn't valid for us
+        class InvalidFrame: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Invalid pre-encoded frame.";
+            }
+        };
+
         //! Error indicating that our receive buffer has overflown before getting a footer
         class BufferOverflow: public std::exception
         {
@@ -130,18 +463,330 @@ namespace Icom
 
     private:
         int m_fd;  //!< File descriptor of serial port.
+        int m_timer;  //!< Timer file descriptor for waking when due
+
+        //! Bytes read from the serial port but not yet received
+        mutable std::array<uint8_t, 256> m_input;
+        mutable size_t m_inputStart;  //!< Index of next byte in m_input
+        mutable size_t m_inputEnd;  //!< Index past last byte in m_input
+
+#ifdef ICOM_IO_URING
+        //! Write any queued bytes and optionally read into m_input
+        /*!
+         * Both are submitted together and waited on with a single system
+         * call. Short writes are resubmitted until everything is out. On a
+         * failed write the read is cancelled, and either error is only
+         * thrown once nothing is left in flight. Given a deadline, the read
+         * is linked to a timeout in the same submission and cancelled when
+         * it expires.
+         *
+         * @param   [in] reading Should we read as well?
+         * @param   [in] deadline Time to give up on the read
+         * @return  Number of bytes read. Zero if the deadline passed first.
+         */
+        size_t transfer(
+                const bool reading,
+                const Clock::time_point deadline
+                    =Clock::time_point::max()) const;
+
+        //! Ring doing the serial port I/O
+        std::unique_ptr<Uring> m_ring;
+
+        //! Bytes put() but not yet written
+        mutable Buffer m_output;
+#endif
+
+        //! Execute a read command, sharing the exchange with identical reads
+        void coalesce(Command_base& command) const;
+
+        //! Execute a single exchange of a command with the bus held
+        bool exchange(Command_base& command) const;
+
+        //! Try to complete a command from the cached device state
+        /*!
+         * If the bus is free, transceive frames waiting to be read are
+         * passed on first so that the state reflects front panel changes.
+         */
+        inline bool recall(Command_base& command) const;
+
+        //! Read and pass on every frame already waiting with the bus held
+        void drain() const;
+
+        //! Complete a command and record its outcome in the device state
+        inline bool complete(Command_base& command) const;
+
+        //! Discard an acknowledgement we've stopped waiting for
+        /*!
+         * The device acknowledges in the order it was sent to so the frame
+         * is only taken to be the oldest expected acknowledgement if that
+         * was sent before the frame a command is awaiting a reply to.
+         *
+         * @param   [in] data Frame contents between the addresses and footer
+         * @param   [in] from Source address of the frame
+         * @param   [in] before Sequence number of the frame awaiting a reply
+         *          from the device, if any
+         * @return  True if the frame was such an acknowledgement.
+         */
+        bool stray(
+                const Buffer& data,
+                const uint8_t from,
+                const unsigned long before
+                    =std::numeric_limits<unsigned long>::max()) const;
+
+        //! Stop waiting for the reply to a command
+        /*!
+         * The command is given a TIMEOUT status. Having been silent so
+         * long, the device is no longer expected to send any skipped
+         * acknowledgements. If the command sets something the cached state
+         * of the device can no longer be trusted.
+         *
+         * @param   [in] command The command to give up on
+         */
+        void giveUp(Command_base& command) const;
+
+        //! Wait with the bus held for a frame to start arriving
+        /*!
+         * Anything put() is written first. With io_uring the write, the read
+         * and its timeout all go out in one system call.
+         *
+         * @param   [in] deadline Time to stop waiting
+         * @return  False if nothing arrived by the deadline.
+         */
+        bool arriving(const Clock::time_point deadline) const;
+
+        //! Longest we keep expecting a skipped acknowledgement
+        static constexpr std::chrono::milliseconds strayTimeout()
+        {
+            return std::chrono::milliseconds(500);
+        }
+
+        //! Longest a device may stay silent while we await its reply
+        /*!
+         * This is on top of the time our own frames take on the wire. It
+         * mustn't be shorter than strayTimeout() as giving up on a reply
+         * also gives up on every skipped acknowledgement from the device.
+         */
+        static constexpr std::chrono::milliseconds replyTimeout()
+        {
+            return std::chrono::milliseconds(500);
+        }
+
+        //! Send and receive one burst of the due commands with the bus held
+        /*!
+         * @param   [in,out] commands The commands still pending. Completed
+         *          ones are removed.
+         * @param   [in] wake Give up the bus if this becomes readable
+         * @return  False if the bus was given up before anything was sent.
+         */
+        bool burst(
+                std::vector<Command_base*>& commands,
+                const int wake=-1) const;
+
+        //! Send the due commands and receive their replies
+        /*!
+         * The bus must already be held and at least one command due.
+         *
+         * @param   [in,out] commands The commands still pending. Completed
+         *          ones are removed.
+         * @param   [in] budgeted Hold back commands the budgets don't allow
+         *          yet. Otherwise only Command_base::due() is respected.
+         */
+        void volley(
+                std::vector<Command_base*>& commands,
+                const bool budgeted=true) const;
+
+        //! Wait with the bus held until at least one of the commands is due
+        /*!
+         * Frames received while waiting are passed to dispatch().
+         *
+         * @param   [in] commands The commands we are waiting on
+         * @param   [in] wake Give up the bus if this becomes readable
+         * @param   [in] keep Never give up the bus
+         * @param   [in] budgeted Consider the budgets in deciding when a
+         *          command is due
+         * @return  True if a command is due. False if we should give up the
+         *          bus because others are waiting for it or we were woken.
+         */
+        bool idle(
+                const std::vector<Command_base*>& commands,
+                const int wake=-1,
+                const bool keep=false,
+                const bool budgeted=true) const;
+
+        //! Wait without the bus until a command is due or a slice has passed
+        /*!
+         * @param   [in] commands The commands we are waiting on
+         * @param   [in] wake Stop waiting if this becomes readable
+         */
+        void rest(
+                const std::vector<Command_base*>& commands,
+                const int wake=-1) const;
+
+        //! Wait without the bus until it is time to claim it for a target
+        void approach(const std::vector<Command_base*>& commands) const;
+
+        //! Earliest time a command may be sent considering budgets
+        Clock::time_point ready(const Command_base& command) const
+        {
+            return std::max(
+                    command.due(),
+                    ready(command.client(), command.device.address));
+        }
+
+        //! Earliest time a client may send to a device considering budgets
+        Clock::time_point ready(
+                const unsigned int client,
+                const uint8_t address) const;
+
+        //! Record a frame of a command against the budgets
+        void charge(const Command_base& command, const size_t bytes) const
+        {
+            charge(command.client(), command.device.address, bytes);
+        }
+
+        //! Record a frame between a client and a device against the budgets
+        void charge(
+                const unsigned int client,
+                const uint8_t address,
+                const size_t bytes) const;
+
+        //! Record a frame seen on the bus against the utilization
+        void meter(const size_t bytes) const;
+
+        //! Bytes of framing around the data of a frame
+        static const size_t framing=5;
+
+        //! Earliest target of the commands. The maximum time point if none.
+        static Clock::time_point target(
+                const std::vector<Command_base*>& commands);
+
+        //! Longest we listen to or sleep off the bus in one go while idle
+        static constexpr std::chrono::milliseconds idleSlice()
+        {
+            return std::chrono::milliseconds(10);
+        }
+
+        //! Pass a frame that isn't a reply on to the relevant commands
+        /*!
+         * Transceive frames broadcast by a device update its cached state and
+         * are given to all of the commands for that device. Anything else is
+         * dropped.
+         *
+         * @param   [in] commands The commands currently pending
+         * @param   [in] data Frame contents between the addresses and footer
+         * @param   [in] to Destination address of the frame
+         * @param   [in] from Source address of the frame
+         */
+        void dispatch(
+                const std::vector<Command_base*>& commands,
+                const Buffer& data,
+                const uint8_t to,
+                const uint8_t from) const;
+
+        //! Send the currently loaded command data as a frame
+        /*!
+         * @param   [in] command The command to send
+         * @return  Sequence number of the frame
+         */
+        inline unsigned long send(Command_base& command) const;
+
+        //! Receive a single frame from the serial port
+        /*!
+         * @param   [out] data Frame contents between the addresses and footer
+         * @param   [out] to Destination address of the frame
+         * @param   [out] from Source address of the frame
+         */
+        inline void receive(Buffer& data, uint8_t& to, uint8_t& from) const;
 
         //! Retrieve a byte from the serial port
         inline uint8_t get() const;
 
         //! Send a string of bytes down the serial port
-        inline void put(const Buffer data) const;
+        /*!
+         * With the io_uring backend the bytes are only queued. They go out
+         * with the next read or flush().
+         */
+        inline void put(const uint8_t* data, const size_t size) const;
 
-        //! Send a byte down the serial port
-        inline void put(const uint8_t byte) const;
+        //! Make sure everything put() has been written
+        inline void flush() const;
 
         //! Address of controller
         const uint8_t m_address;
+
+        //! An acknowledgement skipped by a command but not yet seen
+        struct Stray
+        {
+            unsigned long sequence;  //!< Sequence number of the frame
+            Clock::time_point time;  //!< When it was expected from
+        };
+
+        //! Skipped acknowledgements in sequence order indexed by device
+        //! address. Only touched with the bus held.
+        mutable std::map<uint8_t, std::deque<Stray>> m_strays;
+
+        //! Sequence number of the last frame sent. Only touched with the bus
+        //! held.
+        mutable unsigned long m_sequence;
+
+        //! Skipped acknowledgements that were failures
+        mutable unsigned long m_rejections;
+
+        //! Last known state of each device indexed by address
+        mutable std::map<uint8_t, RadioState> m_states;
+
+        //! Oldest a cached value may be to answer a read. Zero for never.
+        Clock::duration m_maxAge;
+
+        //! Oldest a cached value may be to suppress a set. Zero for never.
+        Clock::duration m_suppressAge;
+
+        //! How far ahead of its target a timed command claims the bus
+        Clock::duration m_lead;
+
+        //! Baud rate of the serial port
+        const unsigned int m_baudRate;
+
+        //! Bus time budgets of limited clients indexed by client
+        mutable std::map<unsigned int, Budget> m_clientBudgets;
+
+        //! Bus time budgets of limited devices indexed by address
+        mutable std::map<uint8_t, Budget> m_deviceBudgets;
+
+        //! Measured utilization of the bus
+        mutable Utilization m_utilization;
+
+        //! A read exchange that other threads can share the reply of
+        struct Flight
+        {
+            Buffer result;  //!< Reply from the device
+            std::exception_ptr error;  //!< Exception thrown by the exchange
+            bool landed;  //!< Set once result or error is available
+
+            Flight(): landed(false) {}
+        };
+
+        //! Read exchanges in flight indexed by device address, client and
+        //! command
+        /*!
+         * Reads are only shared within a client so that one client's
+         * budget never holds up another.
+         */
+        typedef std::map<
+            std::tuple<uint8_t, unsigned int, Buffer>,
+            std::shared_ptr<Flight>> Flights;
+
+        //! Read exchanges currently in flight
+        mutable Flights m_flights;
+
+        //! Notified whenever a Flight lands
+        mutable std::condition_variable m_landed;
+
+        //! Guards the device states, settings and flights
+        mutable std::mutex m_mutex;
+
+        //! Grants the bus to one command or burst at a time
+        mutable Scheduler m_scheduler;
     };
 }
 
@@ -34,6 +34,16 @@
 //! Contains all elements for controlling %Icom devices
 namespace Icom
 {
+    enum duplex_t: uint8_t
+    {
+        SIMPLEX     = 0x10,
+        DUPLEXMINUS = 0x11,
+        DUPLEXPLUS  = 0x12
+    };
+    typedef std::array<std::string, 0x13> duplexNames_t;
+    extern const duplexNames_t duplexNames;
+    STRING_TO_ENUM(duplex)
+
     //! Retrieve the duplex offset of an %Icom CI-V device
     /*!
      * @date    September 21, 2015
@@ -64,6 +74,15 @@ namespace Icom
          */
         int offset() const { return m_offset; }
 
+        //! Record the duplex offset in the device state
+        void update(RadioState& state) const;
+
+        //! Take the duplex offset from the device state if fresh
+        bool recall(const RadioState& state, const Clock::duration maxAge);
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
         //! Make a command object
         /*!
          * @param   [in] dev The %Icom device in question
@@ -89,59 +108,169 @@ namespace Icom
         int m_offset;  //!< Duplex offset
     };
 
-    //! Set the operating duplex of an %Icom CI-V device
+    //! Retrieve the duplex mode of an %Icom CI-V device
     /*!
-     * @date    September 21, 2015
+     * This is only whether the device is in simplex, -duplex or +duplex.
+     * The magnitude of the offset is read with GetDuplex.
+     *
+     * @date    October 19, 2026
      * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
      */
-    class SetDuplex: public Command_base
+    class GetDuplexMode: public Command_base
     {
     public:
+        //! Complete the command
+        /*!
+         * Calling this function forces the child class to process the result
+         * data buffer into the actual duplex mode.
+         *
+         * @return  Always true.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool subcomplete();
+
+        //! Retrieve the duplex mode
+        /*!
+         * The output of this function is only valid once subcomplete() has
+         * been called.
+         *
+         * @return  Current duplex mode of device
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        duplex_t duplex() const { return m_duplex; }
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
         //! Make a command object
         /*!
          * @param   [in] dev The %Icom device in question
-         * @param   [in] offset The desired duplex offset. Zero to disable.
-         * @date    September 21, 2015
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
-        static SetDuplex* make(
-                const device_t& dev,
-                int offset)
+        static GetDuplexMode* make(const device_t& dev)
         {
-            return new SetDuplex(dev, offset);
+            return new GetDuplexMode(dev);
         }
 
-        //! Complete the command
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        GetDuplexMode(const device_t& dev);
+
+        static const uint8_t code=0x0f;  //!< Command code
+
+        duplex_t m_duplex;  //!< Duplex mode
+    };
+
+    //! Set the duplex mode of an %Icom CI-V device
+    /*!
+     * This only selects simplex, -duplex or +duplex. The magnitude of the
+     * offset is set with SetOffset. Use duplexCommands() to get both as a
+     * batch that can be executed in a single burst.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class SetDuplex: public Command_base
+    {
+    public:
+        //! Make a command object
         /*!
-         * Calling this command loads up the second command on the first call.
-         * Returns true on the second call.
+         * This used to take a signed offset and set its magnitude too. It
+         * now only takes the duplex mode so that old callers fail to compile
+         * rather than silently lose the offset. They should use
+         * duplexCommands() instead.
          *
-         * @return  True on second call. False on first.
-         * @date    September 21, 2015
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] duplex The desired duplex mode
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
-        bool subcomplete();
+        static SetDuplex* make(
+                const device_t& dev,
+                duplex_t duplex)
+        {
+            return new SetDuplex(dev, duplex);
+        }
 
-         
     private:
         //! Construct the command object
         /*!
          * @param   [in] dev The %Icom device in question
-         * @param   [in] offset The desired duplex offset. Zero to disable.
-         * @date    September 21, 2015
+         * @param   [in] duplex The desired duplex mode
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
         SetDuplex(
                 const device_t& dev,
-                int offset);
+                duplex_t duplex);
+
+        static const uint8_t code=0x0f;  //!< Command code
+    };
+
+    //! Set the duplex offset of an %Icom CI-V device
+    /*!
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class SetOffset: public Command_base
+    {
+    public:
+        //! Make a command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] offset The magnitude of the desired duplex offset.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static SetOffset* make(
+                const device_t& dev,
+                unsigned int offset)
+        {
+            return new SetOffset(dev, offset);
+        }
 
-        static const uint8_t offset_code=0x0d; //!< Code to set offset
-        static const uint8_t mode_code=0x0f;   //!< Code to set duplex mode
+        //! Record the duplex offset in the device state
+        void update(RadioState& state) const;
+
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] offset The magnitude of the desired duplex offset.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        SetOffset(
+                const device_t& dev,
+                unsigned int offset);
 
-        bool m_started;
+        static const uint8_t code=0x0d;  //!< Command code
 
-        const int m_offset;
+        const unsigned int m_offset;  //!< Desired duplex offset
     };
+
+    //! Make the commands needed to set duplex mode and offset
+    /*!
+     * Neither command depends on the reply to the other so the resulting
+     * batch can be passed to Controller::execute(Commands&) and completed
+     * in a single round trip.
+     *
+     * @param   [in] dev The %Icom device in question
+     * @param   [in] offset The desired duplex offset. Zero to disable.
+     * @return  A SetDuplex command followed by a SetOffset command if the
+     *          offset is non-zero.
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    Commands duplexCommands(const device_t& dev, int offset);
 }
 
 #endif
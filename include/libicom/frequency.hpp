@@ -29,7 +29,11 @@
 #ifndef FREQUENCY_HPP
 #define FREQUENCY_HPP
 
+#include <array>
+#include <limits>
+
 #include "libicom/command.hpp"
+#include "libicom/bcd.hpp"
 
 //! Contains all elements for controlling %Icom devices
 namespace Icom
@@ -64,6 +68,15 @@ namespace Icom
          */
         unsigned int result() const { return m_frequency; }
 
+        //! Record the operating frequency in the device state
+        void update(RadioState& state) const;
+
+        //! Take the operating frequency from the device state if fresh
+        bool recall(const RadioState& state, const Clock::duration maxAge);
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
         //! Make a command object
         /*!
          * @param   [in] dev The %Icom device in question
@@ -107,6 +120,71 @@ namespace Icom
         {
             return new SetFrequency(dev, frequency);
         }
+
+        //! Ready to send command data for a specific frequency
+        typedef std::array<uint8_t, 6> Payload;
+
+        //! Encode the command data for a frequency
+        /*!
+         * This can be evaluated at compile time so that fixed frequency plans
+         * can be stored as tables of ready to send payloads.
+         *
+         * @param   [in] frequency The desired operating frequency
+         * @return  %Command data for make(const device_t&, const Payload&)
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static constexpr Payload payload(unsigned int frequency)
+        {
+            return encode(packBCD(frequency));
+        }
+
+        //! Check that a payload holds a frequency
+        /*!
+         * @param   [in] payload Pointer to command data of a Payload.
+         * @return  True if the command code is right and the %BCD digits are
+         *          valid and fit in an unsigned int.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static constexpr bool valid(const uint8_t* payload)
+        {
+            return payload[0] == code
+                && validBCD(loadBCD(payload+1, 5))
+                && unpackBCD(loadBCD(payload+1, 5))
+                    <= std::numeric_limits<unsigned int>::max();
+        }
+
+        //! Decode the frequency out of a payload
+        /*!
+         * @param   [in] payload Pointer to command data of a Payload.
+         * @return  Frequency in Hertz. Meaningless unless valid() is true
+         *          for the payload.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static constexpr unsigned int frequency(const uint8_t* payload)
+        {
+            return (unsigned int)unpackBCD(loadBCD(payload+1, 5));
+        }
+
+        //! Make a command object from a pre-encoded payload
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] payload Command data as returned by payload()
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static SetFrequency* make(const device_t& dev, const Payload& payload)
+        {
+            return new SetFrequency(dev, payload);
+        }
+
+        //! Record the operating frequency in the device state
+        void update(RadioState& state) const;
+
+        //! Skip if the device is already on this frequency
+        bool suppress(const RadioState& state, const Clock::duration maxAge);
          
     private:
         //! Construct the command object
@@ -118,6 +196,27 @@ namespace Icom
          */
         SetFrequency(const device_t& dev, unsigned int frequency);
 
+        //! Construct the command object from a pre-encoded payload
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] payload Command data as returned by payload()
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        SetFrequency(const device_t& dev, const Payload& payload);
+
+        //! Build a payload from packed %BCD digits
+        static constexpr Payload encode(uint64_t packed)
+        {
+            return Payload{{
+                code,
+                bcdByte(packed, 0),
+                bcdByte(packed, 1),
+                bcdByte(packed, 2),
+                bcdByte(packed, 3),
+                bcdByte(packed, 4)}};
+        }
+
         static const uint8_t code=0x00;  //!< Command code
     };
 }
@@ -0,0 +1,297 @@
+/*!
+ * @file       memory.hpp
+ * @brief      Declares the classes for reading and writing memory channels
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <map>
+#include <vector>
+
+#include "libicom/controller.hpp"
+#include "libicom/mode.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Contents of a memory channel
+    /*!
+     * The contents are kept as the raw bytes the device sends after the
+     * channel number so that every model specific setting survives a round
+     * trip from one device to another. They begin with the frequency, mode
+     * and filter which can be accessed directly.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    struct Memory
+    {
+        Buffer data;  //!< Channel contents. Empty if the channel is blank.
+
+        //! Is the channel blank?
+        bool blank() const { return data.empty(); }
+
+        //! Frequency in Hz. Zero if blank or invalid.
+        unsigned int frequency() const;
+
+        //! Operating mode
+        mode_t mode() const;
+
+        //! Filter width
+        filter_t filter() const;
+
+        //! Make the contents of a channel with only the basics
+        /*!
+         * @param   [in] frequency Frequency in Hz
+         * @param   [in] mode Operating mode
+         * @param   [in] filter Filter width
+         * @return  Channel contents
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static Memory make(
+                const unsigned int frequency,
+                const mode_t mode,
+                const filter_t filter);
+
+        //! Does a channel already hold these contents?
+        /*!
+         * Only as much as these contents specify is compared, so contents
+         * from make() match a full record read from the device if the
+         * frequency, mode and filter agree. Blank contents only match a
+         * blank channel.
+         *
+         * @param   [in] channel Contents read from the channel
+         * @return  True if writing these contents would change nothing
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool matches(const Memory& channel) const;
+
+        bool operator==(const Memory& x) const { return data == x.data; }
+        bool operator!=(const Memory& x) const { return data != x.data; }
+    };
+
+    //! Read a memory channel of an %Icom CI-V device
+    /*!
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class GetMemory: public Command_base
+    {
+    public:
+        //! Complete the command
+        /*!
+         * Calling this function forces the child class to process the result
+         * data buffer into the channel contents.
+         *
+         * @return  Always true.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool subcomplete();
+
+        //! Retrieve the channel contents
+        /*!
+         * The output of this function is only valid once subcomplete() has
+         * been called.
+         *
+         * @return  Contents of the channel
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        const Memory& result() const { return m_memory; }
+
+        //! Which channel is being read
+        unsigned int channel() const { return m_channel; }
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
+        //! Make a command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static GetMemory* make(const device_t& dev, unsigned int channel)
+        {
+            return new GetMemory(dev, channel);
+        }
+
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        GetMemory(const device_t& dev, unsigned int channel);
+
+        const unsigned int m_channel;  //!< Channel being read
+        Memory m_memory;  //!< Retrieved channel contents
+    };
+
+    //! Write a memory channel of an %Icom CI-V device
+    /*!
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class SetMemory: public Command_base
+    {
+    public:
+        //! Make a command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @param   [in] memory Desired contents. Blank clears the channel.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static SetMemory* make(
+                const device_t& dev,
+                unsigned int channel,
+                const Memory& memory)
+        {
+            return new SetMemory(dev, channel, memory);
+        }
+
+        //! Which channel is being written
+        unsigned int channel() const { return m_channel; }
+
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @param   [in] memory Desired contents. Blank clears the channel.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        SetMemory(
+                const device_t& dev,
+                unsigned int channel,
+                const Memory& memory);
+
+        const unsigned int m_channel;  //!< Channel being written
+    };
+
+    //! Clear a memory channel of an %Icom CI-V device
+    /*!
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class ClearMemory: public Command_base
+    {
+    public:
+        //! Make a command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static ClearMemory* make(const device_t& dev, unsigned int channel)
+        {
+            return new ClearMemory(dev, channel);
+        }
+
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] channel Memory channel number
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        ClearMemory(const device_t& dev, unsigned int channel);
+    };
+
+    //! Memory channel contents indexed by channel number
+    typedef std::map<unsigned int, Memory> Memories;
+
+    //! Outcome of syncMemories()
+    struct MemorySync
+    {
+        std::vector<unsigned int> written;  //!< Channels that were changed
+        std::vector<unsigned int> failed;  //!< Channels that couldn't be
+    };
+
+    //! Number of memory commands sent in each burst by default
+    const size_t memoryWindow=8;
+
+    //! Download a range of memory channels
+    /*!
+     * Reads are sent a window at a time in a single burst so the whole
+     * download takes one round trip per window rather than per channel.
+     * Channels that couldn't be read are left out.
+     *
+     * @param   [in] controller Controller of the bus the device is on
+     * @param   [in] dev The %Icom device in question
+     * @param   [in] first First channel number
+     * @param   [in] count Number of channels
+     * @param   [in] window Reads sent in each burst. Keep this within what
+     *          the device can buffer.
+     * @return  Contents of the channels read
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    Memories readMemories(
+            const Controller& controller,
+            const device_t& dev,
+            const unsigned int first,
+            const unsigned int count,
+            const size_t window=memoryWindow);
+
+    //! Bring memory channels in line with a table
+    /*!
+     * Every channel in the table is read and only those that differ are
+     * written. Channels are compared with Memory::matches() so a table of
+     * basic contents from Memory::make() doesn't rewrite channels that only
+     * differ in the settings it leaves out. The writes for each window ride
+     * along in the same burst as the reads of the next so the upload costs
+     * no extra round trips. Channels that can't be read are written anyway.
+     *
+     * @param   [in] controller Controller of the bus the device is on
+     * @param   [in] dev The %Icom device in question
+     * @param   [in] desired Desired contents of each channel. Blank
+     *          contents clear the channel.
+     * @param   [in] window Commands sent in each burst. Keep this within
+     *          what the device can buffer.
+     * @return  Which channels were written and which writes failed
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    MemorySync syncMemories(
+            const Controller& controller,
+            const device_t& dev,
+            const Memories& desired,
+            const size_t window=memoryWindow);
+}
+
+#endif
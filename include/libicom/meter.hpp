@@ -0,0 +1,253 @@
+/*!
+ * @file       meter.hpp
+ * @brief      Declares the Icom::GetMeter and Icom::Sampler classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METER_HPP
+#define METER_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "libicom/controller.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Meter and status readings available through command 0x15
+    enum meter_t: uint8_t
+    {
+        SQUELCHSTATUS  = 0x01,  //!< Squelch open or closed
+        SMETER         = 0x02,  //!< S-meter level
+        VARIOUSSQUELCH = 0x05,  //!< Various squelch status
+        POWERMETER     = 0x11,  //!< RF power meter level
+        SWRMETER       = 0x12,  //!< SWR meter level
+        ALCMETER       = 0x13,  //!< ALC meter level
+        COMPMETER      = 0x14,  //!< Compression meter level
+        VOLTAGEMETER   = 0x15,  //!< Supply voltage meter level
+        CURRENTMETER   = 0x16   //!< Supply current meter level
+    };
+    typedef std::array<std::string, 0x17> meterNames_t;
+    extern const meterNames_t meterNames;
+    STRING_TO_ENUM(meter)
+
+    //! Read a meter or status of an %Icom CI-V device
+    /*!
+     * Status readings (squelch) are a single byte of zero or one. Meter
+     * levels are four BCD digits from 0 to 255.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class GetMeter: public Command_base
+    {
+    public:
+        //! Retrieve the reading
+        /*!
+         * The output of this function is only valid once subcomplete() has
+         * been called.
+         *
+         * @return  Meter level or status
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        unsigned int result() const { return m_value; }
+
+        //! Which meter is being read
+        meter_t meter() const { return m_meter; }
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
+        //! Make a command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] meter The meter to read
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static GetMeter* make(const device_t& dev, meter_t meter)
+        {
+            return new GetMeter(dev, meter);
+        }
+
+    private:
+        //! Construct the command object
+        /*!
+         * @param   [in] dev The %Icom device in question
+         * @param   [in] meter The meter to read
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        GetMeter(const device_t& dev, meter_t meter);
+
+        //! Parse the reading
+        bool subcomplete();
+
+        static const uint8_t code=0x15;  //!< Command code
+
+        const meter_t m_meter;  //!< Meter being read
+        unsigned int m_value;  //!< Meter level or status
+    };
+
+    //! Timestamped meter reading
+    struct Sample
+    {
+        Clock::time_point time;  //!< Time the read was sent
+        uint8_t address;  //!< Address of the device
+        meter_t meter;  //!< Meter that was read
+        uint16_t value;  //!< Meter level or status
+    };
+
+    //! Lock free ring buffer of samples with one producer and one consumer
+    /*!
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class SampleRing
+    {
+    public:
+        //! Sole constructor
+        /*!
+         * @param   [in] capacity Samples the ring can hold. Rounded up to a
+         *          power of two.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        SampleRing(const size_t capacity);
+
+        //! Add a sample. Producer only.
+        /*!
+         * @param   [in] sample Sample to add
+         * @return  False if the ring is full and the sample was dropped.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool push(const Sample& sample);
+
+        //! Take samples out of the ring. Consumer only.
+        /*!
+         * @param   [out] samples Where to put the samples, oldest first
+         * @param   [in] size Most samples to take
+         * @return  Number of samples taken
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        size_t pop(Sample* samples, const size_t size);
+
+    private:
+        std::vector<Sample> m_samples;  //!< Storage
+        const size_t m_mask;  //!< Mask from position to index
+
+        //! Position of the next sample to pop. Written by the consumer.
+        alignas(64) std::atomic<size_t> m_head;
+
+        //! Position of the next sample to push. Written by the producer.
+        alignas(64) std::atomic<size_t> m_tail;
+    };
+
+    //! Continuously samples meters into a ring buffer
+    /*!
+     * A thread of its own reads every channel as one batch (see
+     * Controller::execute(Commands&)) over and over, as fast as the bus
+     * allows. The reads are BACKGROUND priority so other commands still get
+     * the bus in between batches. Samples that don't fit in the ring are
+     * dropped and counted.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Sampler
+    {
+    public:
+        //! A meter to sample
+        struct Channel
+        {
+            device_t device;  //!< Device to read
+            meter_t meter;  //!< Meter to read
+        };
+
+        //! Start sampling
+        /*!
+         * @param   [in] controller Controller of the bus the devices are on
+         * @param   [in] channels Meters to sample
+         * @param   [in] capacity Samples the ring can hold
+         * @param   [in] interval Shortest time between batches. Zero to go
+         *          as fast as the bus allows. After a failed batch we wait
+         *          at least backoff milliseconds.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Sampler(
+                const Controller& controller,
+                const std::vector<Channel>& channels,
+                const size_t capacity=4096,
+                const Clock::duration interval=Clock::duration::zero());
+
+        //! Stop sampling
+        ~Sampler();
+
+        //! Take samples. Only one thread may do this.
+        /*!
+         * @param   [out] samples Where to put the samples, oldest first
+         * @param   [in] size Most samples to take
+         * @return  Number of samples taken
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        size_t drain(Sample* samples, const size_t size)
+        {
+            return m_ring.pop(samples, size);
+        }
+
+        //! Number of samples dropped because the ring was full
+        size_t dropped() const { return m_dropped; }
+
+        //! Number of batches that failed with an exception
+        size_t errors() const { return m_errors; }
+
+        //! Milliseconds to wait after a failed batch
+        static const unsigned int backoff=100;
+
+    private:
+        //! Body of the sampling thread
+        void run();
+
+        const Controller& m_controller;  //!< Controller of the bus
+        const std::vector<Channel> m_channels;  //!< Meters to sample
+        const Clock::duration m_interval;  //!< Shortest time between batches
+        SampleRing m_ring;  //!< Samples waiting to be drained
+        std::atomic<size_t> m_dropped;  //!< Samples dropped
+        std::atomic<size_t> m_errors;  //!< Batches failed
+        std::atomic<bool> m_running;  //!< Cleared to stop the thread
+        std::thread m_thread;  //!< The sampling thread
+
+        Sampler(const Sampler&);
+        Sampler& operator=(const Sampler&);
+    };
+}
+
+#endif
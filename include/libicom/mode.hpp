@@ -107,6 +107,15 @@ namespace Icom
          */
         filter_t filter() const { return m_filter; }
 
+        //! Record the operating mode in the device state
+        void update(RadioState& state) const;
+
+        //! Take the operating mode from the device state if fresh
+        bool recall(const RadioState& state, const Clock::duration maxAge);
+
+        //! Reading has no effect on the device
+        bool readOnly() const { return true; }
+
         //! Make a command object
         /*!
          * @param   [in] dev The %Icom device in question
@@ -156,6 +165,22 @@ namespace Icom
         {
             return new SetMode(dev, mode, filter);
         }
+
+        //! Record the operating mode in the device state
+        void update(RadioState& state) const;
+
+        //! Skip if the device is already in this mode
+        /*!
+         * Without an explicit filter we can't know which filter the device
+         * would pick so this is never skipped.
+         *
+         * @param   [in] state Cached state of our device
+         * @param   [in] maxAge Oldest a cached value may be to be trusted
+         * @return  True if the command was completed without the device.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool suppress(const RadioState& state, const Clock::duration maxAge);
          
     private:
         //! Construct the command object
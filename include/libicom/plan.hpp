@@ -0,0 +1,166 @@
+/*!
+ * @file       plan.hpp
+ * @brief      Declares the Icom::FrequencyPlan class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLAN_HPP
+#define PLAN_HPP
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "libicom/device.hpp"
+#include "libicom/frequency.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! A pre-encoded frequency plan stored on disk
+    /*!
+     * The file holds every channel of the plan as a complete SetFrequency
+     * frame addressed from a specific controller to a specific device, so
+     * hopping through it needs no %BCD encoding at all. The file is memory
+     * mapped and nothing is read on opening beyond a small header so even
+     * very large plans open immediately.
+     *
+     * Frames can be written to the bus verbatim with Controller::hop() or
+     * their command data can be used to make SetFrequency commands with
+     * payload().
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class FrequencyPlan
+    {
+    public:
+        //! Bytes in each frame of the plan
+        static const size_t frameSize=11;
+
+        //! Encode a plan and write it to a file
+        /*!
+         * @param   [in] path Path of the file. Replaced if it exists.
+         * @param   [in] device The %Icom device the plan is for
+         * @param   [in] controller Address of the controller that will send
+         *          the frames
+         * @param   [in] frequencies Frequency of each channel in Hz
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static void write(
+                const std::string& path,
+                const device_t& device,
+                const uint8_t controller,
+                const std::vector<unsigned int>& frequencies);
+
+        //! Open and map a plan
+        /*!
+         * @param   [in] path Path of the file
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        FrequencyPlan(const std::string& path);
+
+        ~FrequencyPlan();
+
+        //! The %Icom device the plan is for
+        device_t device() const { return m_device; }
+
+        //! Address of the controller the frames are from
+        uint8_t controller() const { return m_controller; }
+
+        //! Number of channels in the plan
+        size_t size() const { return m_size; }
+
+        //! Complete frame of a channel
+        /*!
+         * @param   [in] channel Index of the channel
+         * @return  Pointer to frameSize bytes ready to be sent
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        const uint8_t* frame(const size_t channel) const
+        {
+            return m_frames + channel*frameSize;
+        }
+
+        //! %Command data of a channel
+        /*!
+         * @param   [in] channel Index of the channel
+         * @return  Payload for SetFrequency::make(const device_t&, const
+         *          SetFrequency::Payload&)
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        SetFrequency::Payload payload(const size_t channel) const;
+
+        //! Frequency of a channel in Hz
+        /*!
+         * Frames aren't checked on opening. This is meaningless unless
+         * SetFrequency::valid() is true for the frame's command data.
+         *
+         * @param   [in] channel Index of the channel
+         * @return  Frequency in Hz
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        unsigned int frequency(const size_t channel) const
+        {
+            return SetFrequency::frequency(frame(channel)+4);
+        }
+
+        //! Error indicating failure to open or map the file
+        class CantOpenPlan: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to open frequency plan.";
+            }
+        };
+
+        //! Error indicating the file isn't a valid frequency plan
+        class InvalidPlan: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Invalid frequency plan.";
+            }
+        };
+
+    private:
+        device_t m_device;  //!< Device the plan is for
+        uint8_t m_controller;  //!< Controller the frames are from
+        size_t m_size;  //!< Number of channels
+        int m_fd;  //!< File descriptor of the file
+        const uint8_t* m_map;  //!< Mapping of the file
+        size_t m_length;  //!< Size of the mapping
+        const uint8_t* m_frames;  //!< First frame in the mapping
+
+        FrequencyPlan(const FrequencyPlan&);
+        FrequencyPlan& operator=(const FrequencyPlan&);
+    };
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*!
+ * @file       poller.hpp
+ * @brief      Declares the Icom::Poller class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLLER_HPP
+#define POLLER_HPP
+
+#include <array>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+#include "libicom/controller.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Periodically polls devices from a single thread
+    /*!
+     * Each registration names a controller, a device, a factory making the
+     * command to poll it with and an interval. Registrations are kept in a
+     * hierarchical timer wheel so that thousands of them cost next to nothing
+     * between polls. All polls falling due in the same tick are run together
+     * as one batch per controller (see Controller::execute(Commands&)) and
+     * their results are delivered to callbacks from the polling thread.
+     *
+     * Since polls of a batch are sent back to back, polls falling due
+     * together must not depend on each other.
+     *
+     * Registrations can instead be given an interval range. Their interval
+     * then adapts to how often the polled value is seen to change, judged by
+     * comparing the reply to each poll with the last. A change drops the
+     * interval straight to the minimum. Without changes it backs off towards
+     * a few polls per typical time between changes, up to the maximum.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Poller
+    {
+    public:
+        //! Makes the command to poll a device with
+        typedef std::function<Command(const device_t& device)> Factory;
+
+        //! Receives each completed poll
+        /*!
+         * If the exchange failed with an exception the command status is
+         * left as INCOMPLETE.
+         */
+        typedef std::function<void(const Command& command)> Callback;
+
+        //! Identifies a registration
+        typedef unsigned long Handle;
+
+        //! Start the polling thread
+        /*!
+         * @param   [in] tick Resolution of poll intervals
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Poller(const Clock::duration tick=std::chrono::milliseconds(10));
+
+        //! Stop the polling thread
+        ~Poller();
+
+        //! Start polling a device
+        /*!
+         * The first poll is run one interval from now.
+         *
+         * @param   [in] controller Controller of the bus the device is on
+         * @param   [in] device The %Icom device in question
+         * @param   [in] factory Makes the command to poll with
+         * @param   [in] interval Time between polls. Rounded up to a whole
+         *          number of ticks.
+         * @param   [in] callback Receives each completed poll
+         * @return  Handle to remove the registration with
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Handle add(
+                const Controller& controller,
+                const device_t& device,
+                const Factory& factory,
+                const Clock::duration interval,
+                const Callback& callback);
+
+        //! Start polling a device at an adaptive rate
+        /*!
+         * The first poll is run one minimum interval from now.
+         *
+         * @param   [in] controller Controller of the bus the device is on
+         * @param   [in] device The %Icom device in question
+         * @param   [in] factory Makes the command to poll with
+         * @param   [in] minInterval Time between polls right after a change.
+         *          Rounded up to a whole number of ticks.
+         * @param   [in] maxInterval Longest time between polls. Rounded up
+         *          to a whole number of ticks.
+         * @param   [in] callback Receives each completed poll
+         * @return  Handle to remove the registration with
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Handle add(
+                const Controller& controller,
+                const device_t& device,
+                const Factory& factory,
+                const Clock::duration minInterval,
+                const Clock::duration maxInterval,
+                const Callback& callback);
+
+        //! Current time between polls of a registration
+        /*!
+         * @param   [in] handle Handle returned by add()
+         * @return  Interval. Zero if the handle isn't registered.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Clock::duration interval(const Handle handle);
+
+        //! Stop polling a device
+        /*!
+         * A poll already being run still has its result delivered.
+         *
+         * @param   [in] handle Handle returned by add()
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void remove(const Handle handle);
+
+        //! Make a factory for a command class taking only a device
+        /*!
+         * @return  Factory calling T::make()
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        template<typename T> static Factory factory()
+        {
+            return [](const device_t& device)
+            {
+                return Command(T::make(device));
+            };
+        }
+
+    private:
+        //! A device being polled
+        struct Registration
+        {
+            const Controller& controller;  //!< Controller of its bus
+            const device_t device;  //!< Device to poll
+            const Factory factory;  //!< Makes the poll command
+            const Callback callback;  //!< Receives the results
+            const unsigned long minimum;  //!< Fewest ticks between polls
+            const unsigned long maximum;  //!< Most ticks between polls
+            unsigned long interval;  //!< Ticks between polls
+            Buffer last;  //!< Reply to the last successful poll
+            unsigned long changed;  //!< Tick of the last change seen
+            double gap;  //!< Average ticks between changes. Zero if none.
+            unsigned long expiry;  //!< Tick of the next poll
+            bool armed;  //!< Is it in the wheel?
+            bool active;  //!< Cleared when removed
+            unsigned int level;  //!< Wheel level it is in when armed
+            //! Place in its slot when armed
+            std::list<std::shared_ptr<Registration>>::iterator position;
+        };
+
+        //! Registrations falling due in the same tick
+        typedef std::list<std::shared_ptr<Registration>> Slot;
+
+        static const unsigned int levels=4;  //!< Levels of the wheel
+        static const unsigned int bits=8;  //!< Bits of tick per level
+        static const unsigned int slots=1<<bits;  //!< Slots per level
+
+        //! Put a registration in the wheel according to its expiry
+        void arm(const std::shared_ptr<Registration>& registration);
+
+        //! Take a registration out of the wheel
+        void disarm(Registration& registration);
+
+        //! Advance the wheel one tick collecting whatever is due
+        void advance(std::vector<std::shared_ptr<Registration>>& due);
+
+        //! Adjust the interval of an adaptive registration after a poll
+        void adapt(Registration& registration, const Command& command);
+
+        //! Polls wanted per average time between changes
+        static const unsigned int pollsPerChange=4;
+
+        //! The latest gap between changes has one over this much weight in
+        //! the running average
+        static const unsigned int gapSmoothing=4;
+
+        //! Body of the polling thread
+        void run();
+
+        //! Tick count of a time
+        unsigned long ticks(const Clock::time_point time) const;
+
+        const Clock::duration m_tick;  //!< Duration of a tick
+        const Clock::time_point m_epoch;  //!< Time of tick zero
+        unsigned long m_now;  //!< Last tick processed
+
+        //! The wheel. Level n slots cover slots^n ticks each.
+        std::array<std::array<Slot, slots>, levels> m_wheel;
+
+        //! All registrations indexed by handle
+        std::map<Handle, std::shared_ptr<Registration>> m_registrations;
+
+        Handle m_next;  //!< Next handle to give out
+        bool m_running;  //!< Cleared to stop the thread
+        std::mutex m_mutex;  //!< Guards everything
+        std::condition_variable m_stopped;  //!< Notified when stopping
+
+        std::thread m_thread;  //!< The polling thread
+
+        Poller(const Poller&);
+        Poller& operator=(const Poller&);
+    };
+}
+
+#endif
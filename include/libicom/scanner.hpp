@@ -0,0 +1,202 @@
+/*!
+ * @file       scanner.hpp
+ * @brief      Declares the Icom::Scanner class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <exception>
+
+#include "libicom/controller.hpp"
+#include "libicom/plan.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Scans a list of channels stopping on activity
+    /*!
+     * A thread of its own steps the device through the channels. Once the
+     * receiver has settled on a channel its squelch is read and the next
+     * channel is set in the same burst, so each step costs a single round
+     * trip on the bus. Scanning a FrequencyPlan the next channel is instead
+     * hopped to straight after the squelch reply. If the squelch was open
+     * the device is tuned back and held on that channel until the squelch
+     * has stayed closed for the hang time.
+     *
+     * A failed exchange on the bus is counted and the scan moves on to the
+     * next channel after a short back off. An exception thrown by the
+     * callback stops the scan and can be retrieved with rethrow().
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Scanner
+    {
+    public:
+        //! Called with the frequency of each channel the scan stops on
+        typedef std::function<void(unsigned int frequency)> Callback;
+
+        //! Start scanning
+        /*!
+         * @param   [in] controller Controller of the bus the device is on
+         * @param   [in] device The %Icom device to scan with
+         * @param   [in] channels Frequencies to scan in Hz
+         * @param   [in] callback Called whenever the scan stops on a channel
+         * @param   [in] settle Time the receiver needs after tuning before
+         *          its squelch means anything
+         * @param   [in] hang Time the squelch must stay closed before the
+         *          scan resumes
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Scanner(
+                const Controller& controller,
+                const device_t& device,
+                const std::vector<unsigned int>& channels,
+                const Callback& callback,
+                const Clock::duration settle=std::chrono::milliseconds(15),
+                const Clock::duration hang=std::chrono::seconds(2));
+
+        //! Start scanning through a pre-encoded plan
+        /*!
+         * The channels are written to the bus straight out of the plan with
+         * Controller::hop() so nothing is encoded or built per channel while
+         * scanning.
+         *
+         * @param   [in] controller Controller of the bus the device is on
+         * @param   [in] plan Plan to scan. Its device is the one scanned
+         *          with.
+         * @param   [in] callback Called whenever the scan stops on a channel
+         * @param   [in] settle Time the receiver needs after tuning before
+         *          its squelch means anything
+         * @param   [in] hang Time the squelch must stay closed before the
+         *          scan resumes
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Scanner(
+                const Controller& controller,
+                const std::shared_ptr<const FrequencyPlan>& plan,
+                const Callback& callback,
+                const Clock::duration settle=std::chrono::milliseconds(15),
+                const Clock::duration hang=std::chrono::seconds(2));
+
+        //! Stop scanning
+        ~Scanner();
+
+        //! Make a channel list from a frequency range
+        /*!
+         * @param   [in] start First frequency in Hz
+         * @param   [in] stop Last frequency in Hz
+         * @param   [in] step Channel spacing in Hz
+         * @return  Frequencies from start to stop inclusive
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static std::vector<unsigned int> range(
+                const unsigned int start,
+                const unsigned int stop,
+                const unsigned int step);
+
+        //! Average rate of scanning
+        /*!
+         * Time spent holding on active channels isn't counted.
+         *
+         * @return  Channels per second
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double rate() const;
+
+        //! Number of exchanges with the device that failed
+        unsigned long errors() const { return m_errors; }
+
+        //! Rethrow the exception thrown by the callback, if any
+        /*!
+         * Once the callback has thrown the scan stops. Does nothing if the
+         * callback hasn't thrown.
+         *
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void rethrow() const;
+
+        //! Milliseconds to wait after a failed exchange
+        static const unsigned int backoff=100;
+
+    private:
+        //! Body of the scanning thread
+        void run();
+
+        //! Hold on a channel until its squelch has been closed long enough
+        void hold(const size_t channel);
+
+        //! Number of channels
+        size_t channels() const
+        {
+            return m_plan ? m_plan->size() : m_channels.size();
+        }
+
+        //! Frequency of a channel in Hz
+        unsigned int frequency(const size_t channel) const
+        {
+            return m_plan ? m_plan->frequency(channel) : m_channels[channel];
+        }
+
+        //! Tune the device to a channel
+        void tune(const size_t channel) const;
+
+        //! Count a failed exchange and back off
+        void failed();
+
+        const Controller& m_controller;  //!< Controller of the bus
+        const device_t m_device;  //!< Device we scan with
+        const std::vector<unsigned int> m_channels;  //!< Frequencies
+        const std::shared_ptr<const FrequencyPlan> m_plan;  //!< Or a plan
+        const Callback m_callback;  //!< Told about active channels
+        const Clock::duration m_settle;  //!< Settling time after tuning
+        const Clock::duration m_hang;  //!< Hang time after activity
+
+        std::atomic<unsigned long> m_stepped;  //!< Channels scanned
+        std::atomic<Clock::rep> m_scanning;  //!< Time spent scanning
+        std::atomic<unsigned long> m_errors;  //!< Failed exchanges
+        mutable std::mutex m_mutex;  //!< Guards m_failure
+        std::exception_ptr m_failure;  //!< Thrown by the callback
+        std::atomic<bool> m_running;  //!< Cleared to stop the thread
+        std::thread m_thread;  //!< The scanning thread
+
+        Scanner(const Scanner&);
+        Scanner& operator=(const Scanner&);
+    };
+}
+
+#endif
@@ -0,0 +1,167 @@
+/*!
+ * @file       scheduler.hpp
+ * @brief      Declares the Icom::Scheduler class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <list>
+#include <mutex>
+#include <condition_variable>
+
+#include "libicom/command.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Class for arbitrating access to the CI-V bus
+    /*!
+     * Threads wanting the bus take a Ticket with the priority_t of the work
+     * they want to do. When the bus is released it is handed to the waiting
+     * ticket of the highest priority, oldest first within a priority.
+     *
+     * Tickets for timed work also carry a deadline. These go ahead of any
+     * priority with the earliest deadline first.
+     *
+     * To keep the lower priorities moving, a waiting ticket is promoted by
+     * one priority for each promotion period it has waited.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Scheduler
+    {
+    public:
+        //! Sole constructor
+        /*!
+         * @param   [in] promotion Waiting period per priority promotion
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Scheduler(const Clock::duration promotion);
+
+        //! Holds the bus for as long as it exists
+        /*!
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        class Ticket
+        {
+        public:
+            //! Wait for the bus
+            /*!
+             * @param   [in] scheduler The scheduler of the bus we want
+             * @param   [in] priority Priority of the work we want to do
+             * @param   [in] deadline Time the work must be done by. The
+             *          maximum time point for none.
+             * @date    October 19, 2026
+             * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+             */
+            Ticket(
+                    Scheduler& scheduler,
+                    const priority_t priority,
+                    const Clock::time_point deadline=Clock::time_point::max());
+
+            //! Take the bus only if nobody holds it
+            /*!
+             * @param   [in] scheduler The scheduler of the bus we want
+             * @date    October 19, 2026
+             * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+             */
+            Ticket(Scheduler& scheduler, std::try_to_lock_t);
+
+            //! Hand the bus to the next ticket
+            ~Ticket();
+
+            //! Do we hold the bus?
+            bool held() const { return m_held; }
+
+        private:
+            Scheduler& m_scheduler;  //!< Scheduler we hold the bus of
+            const bool m_held;  //!< Do we hold the bus?
+
+            Ticket(const Ticket&);
+            Ticket& operator=(const Ticket&);
+        };
+
+        //! Is anybody waiting for the bus?
+        /*!
+         * Whoever holds the bus should check this while idle and release the
+         * bus if it returns true.
+         *
+         * @return  True if there are tickets waiting.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool contended() const;
+
+        //! Set the waiting period per priority promotion
+        /*!
+         * @param   [in] promotion Waiting period per priority promotion
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void promoteAfter(const Clock::duration promotion);
+
+    private:
+        //! A ticket waiting for the bus
+        struct Waiter
+        {
+            const priority_t priority;  //!< Requested priority
+            const Clock::time_point deadline;  //!< Requested deadline
+            const Clock::time_point since;  //!< When we started waiting
+            bool granted;  //!< Set when we are given the bus
+        };
+
+        //! Wait for the bus
+        void acquire(
+                const priority_t priority,
+                const Clock::time_point deadline);
+
+        //! Take the bus if nobody holds it
+        bool tryAcquire();
+
+        //! Hand the bus to the best waiter if there is one
+        void release();
+
+        //! Tickets waiting for the bus in order of arrival
+        std::list<Waiter*> m_waiters;
+
+        //! Notified whenever the bus is handed to a waiter
+        std::condition_variable m_granted;
+
+        //! Guards everything
+        mutable std::mutex m_mutex;
+
+        //! Is the bus held?
+        bool m_busy;
+
+        //! Waiting period per priority promotion
+        Clock::duration m_promotion;
+    };
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*!
+ * @file       snapshot.hpp
+ * @brief      Declares functions for saving and restoring the state of a device
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "libicom/controller.hpp"
+#include "libicom/mode.hpp"
+#include "libicom/vfo.hpp"
+#include "libicom/duplex.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Saved configuration of an %Icom device
+    /*!
+     * This is plain data so it can be copied around or stored as is.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    struct Snapshot
+    {
+        uint32_t frequency;  //!< Operating frequency in Hz
+        uint32_t offset;  //!< Magnitude of duplex offset in Hz
+        mode_t mode;  //!< Operating mode
+        filter_t filter;  //!< Filter width
+        duplex_t duplex;  //!< Duplex mode
+        vfoState_t vfo;  //!< Selected %VFO
+        bool vfoKnown;  //!< The %VFO can't be read so may not be known
+    };
+
+    //! Save the configuration of a device
+    /*!
+     * All of the reads are sent in a single burst. The selected %VFO can't
+     * be read from the device so it is taken from the cached state of the
+     * Controller if it is known there.
+     *
+     * @param   [in] controller Controller of the bus the device is on
+     * @param   [in] dev The %Icom device in question
+     * @return  Configuration of the device
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    Snapshot snapshot(const Controller& controller, const device_t& dev);
+
+    //! Restore a saved configuration to a device
+    /*!
+     * All of the sets are sent in a single burst with Controller::transact()
+     * so nothing else can get at the device in between. The device handles
+     * them in order so the %VFO is selected before anything is set on it.
+     * Setting the frequency isn't acknowledged so it is read back at the
+     * end of the burst.
+     *
+     * @param   [in] controller Controller of the bus the device is on
+     * @param   [in] dev The %Icom device in question
+     * @param   [in] snapshot Configuration to restore
+     * @return  True if every set succeeded and the frequency reads back
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    bool restore(
+            const Controller& controller,
+            const device_t& dev,
+            const Snapshot& snapshot);
+
+    //! Error indicating that the configuration couldn't be read
+    class SnapshotFailed: public std::exception
+    {
+        const char* what() const throw()
+        {
+            return "Unable to read device configuration.";
+        }
+    };
+}
+
+#endif
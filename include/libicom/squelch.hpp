@@ -45,7 +45,16 @@ namespace Icom
 
     //! Wait for the squelch of an %Icom CI-V device to change
     /*!
-     * @date    September 23, 2015
+     * The squelch status is polled, starting at the minimum interval and
+     * doubling after each poll that doesn't match up to the maximum
+     * interval. Any transceive frame from the device is taken as a sign of
+     * activity and brings the next poll forward to immediately at the
+     * minimum interval.
+     *
+     * The Controller doesn't occupy the bus in between polls so other
+     * commands can be run while we wait.
+     *
+     * @date    October 19, 2026
      * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
      */
     class SquelchHold: public Command_base
@@ -55,35 +64,81 @@ namespace Icom
         /*!
          * @param   [in] dev The %Icom device in question
          * @param   [in] state The state we should wait for the squelch to be.
-         * @date    September 23, 2015
+         * @param   [in] timeout Give up with a TIMEOUT status after this
+         *          long. Zero to wait forever.
+         * @param   [in] minInterval Interval between polls right after
+         *          starting or seeing activity.
+         * @param   [in] maxInterval Upper limit of the interval between
+         *          polls as it backs off.
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
-        static SquelchHold* make(const device_t& dev, squelchState_t state)
+        static SquelchHold* make(
+                const device_t& dev,
+                squelchState_t state,
+                std::chrono::milliseconds timeout=std::chrono::milliseconds(0),
+                std::chrono::milliseconds minInterval=defaultMinInterval(),
+                std::chrono::milliseconds maxInterval=defaultMaxInterval())
         {
-            return new SquelchHold(dev, state);
+            return new SquelchHold(
+                    dev,
+                    state,
+                    timeout,
+                    minInterval,
+                    maxInterval);
         }
+
+        //! Default interval between polls right after starting
+        static constexpr std::chrono::milliseconds defaultMinInterval()
+        {
+            return std::chrono::milliseconds(20);
+        }
+
+        //! Default upper limit of the interval between polls
+        static constexpr std::chrono::milliseconds defaultMaxInterval()
+        {
+            return std::chrono::milliseconds(320);
+        }
+
+        //! Bring the next poll forward on device activity
+        void transceive(const Buffer& data);
+
     private:
         //! Construct the command object
         /*!
          * @param   [in] dev The %Icom device in question
          * @param   [in] state The state we should wait for the squelch to be.
-         * @date    September 23, 2015
+         * @param   [in] timeout Give up after this long. Zero for never.
+         * @param   [in] minInterval Interval between polls after activity.
+         * @param   [in] maxInterval Upper limit of the interval between polls.
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
-        SquelchHold(const device_t& dev, squelchState_t state);
+        SquelchHold(
+                const device_t& dev,
+                squelchState_t state,
+                std::chrono::milliseconds timeout,
+                std::chrono::milliseconds minInterval,
+                std::chrono::milliseconds maxInterval);
 
         //! Complete the command
         /*!
-         * Returns false until the squelch changes to the specified state
+         * Returns false and schedules the next poll until the squelch changes
+         * to the specified state or we time out.
          *
-         * @return  Always true.
-         * @date    September 23, 2015
+         * @return  True once done.
+         * @date    October 19, 2026
          * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
          */
         bool subcomplete();
 
         const squelchState_t m_squelchState;
 
+        const Clock::time_point m_deadline;  //!< Give up at this time
+        const Clock::duration m_minInterval;  //!< Shortest poll interval
+        const Clock::duration m_maxInterval;  //!< Longest poll interval
+        Clock::duration m_interval;  //!< Interval until the next poll
+
         static const uint8_t code=0x15;  //!< Command code
         static const uint8_t subCode=0x01;  //!< Subcommand code
     };
@@ -0,0 +1,131 @@
+/*!
+ * @file       state.hpp
+ * @brief      Declares the structures for caching the state of an %Icom
+ *             device.
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATE_HPP
+#define STATE_HPP
+
+#include "libicom/command.hpp"
+#include "libicom/mode.hpp"
+#include "libicom/vfo.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! A cached value along with when it was last known to be true
+    /*!
+     * A value is either confirmed, because the device reported or
+     * acknowledged it, or only assumed because we sent it without the
+     * device acknowledging it. Only confirmed values may suppress sets.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    template<typename T> struct Known
+    {
+        T value;  //!< Last known value
+        Clock::time_point time;  //!< When value was last known to be true
+        bool assumed;  //!< The device hasn't confirmed the value
+
+        Known(): value(), time(), assumed(false) {}
+
+        //! Is the value known and no older than maxAge?
+        bool fresh(const Clock::duration maxAge) const
+        {
+            return time != Clock::time_point()
+                && Clock::now()-time <= maxAge;
+        }
+
+        //! Is the value confirmed by the device and no older than maxAge?
+        bool confirmed(const Clock::duration maxAge) const
+        {
+            return !assumed && fresh(maxAge);
+        }
+
+        //! Record a newly confirmed value
+        void set(const T& newValue)
+        {
+            value = newValue;
+            time = Clock::now();
+            assumed = false;
+        }
+
+        //! Record a value sent to the device without acknowledgement
+        void assume(const T& newValue)
+        {
+            value = newValue;
+            time = Clock::now();
+            assumed = true;
+        }
+
+        //! Forget the value
+        void invalidate()
+        {
+            time = Clock::time_point();
+        }
+    };
+
+    //! Last known state of an %Icom device
+    /*!
+     * This is kept up to date by the Controller from the commands it runs
+     * on the device and from the transceive frames the device broadcasts.
+     * Transceive frames are only seen when the bus is read. Before a read
+     * is answered from the cache any frames already waiting are read, but
+     * a change still on the wire at that moment is missed, so maxAge
+     * should reflect how stale a value may acceptably be.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    struct RadioState
+    {
+        Known<unsigned int> frequency;  //!< Operating frequency in Hertz
+        Known<mode_t> mode;  //!< Operating mode
+        Known<filter_t> filter;  //!< Filter width
+        Known<unsigned int> offset;  //!< Magnitude of duplex offset
+        Known<vfoState_t> vfo;  //!< Selected %VFO. Only VFOA or VFOB.
+
+        //! Forget everything
+        void invalidate();
+
+        //! Update the state from a transceive frame
+        /*!
+         * Frequency and mode frames are recorded. Since we can't know what
+         * else changed on the device, anything else invalidates the state.
+         *
+         * @param   [in] data Frame contents between the addresses and footer
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void transceive(const Buffer& data);
+
+        static const uint8_t frequencyCode=0x00;  //!< Transceive frequency code
+        static const uint8_t modeCode=0x01;  //!< Transceive mode code
+    };
+}
+
+#endif
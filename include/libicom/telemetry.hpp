@@ -0,0 +1,239 @@
+/*!
+ * @file       telemetry.hpp
+ * @brief      Declares the Icom::TelemetryWriter and Icom::TelemetryReader
+ *             classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <cstdint>
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Appends telemetry rows to a memory mapped columnar file
+    /*!
+     * Each row is a timestamp and a fixed number of integer fields, for
+     * example the frequency, mode and squelch state of one radio. Rows are
+     * collected into blocks. Each column of a block is stored as the
+     * differences between consecutive values, run length encoded, so that
+     * regular timestamps and values that rarely change take next to no
+     * space. Every block is headed by its time range so a reader can find
+     * the blocks it wants without decoding the others.
+     *
+     * Rows are kept in time order. See append(). Use one file per radio to
+     * keep the columns of each radio smooth.
+     *
+     * A block only becomes part of the file once it is complete, so a
+     * writer process that dies leaves a readable file. Nothing is synced to
+     * disk though. Blocks still in the page cache are lost if the machine
+     * itself goes down.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class TelemetryWriter
+    {
+    public:
+        //! Open a file for appending, creating it if need be
+        /*!
+         * @param   [in] path Path of the file
+         * @param   [in] fields Number of fields in a row, not counting the
+         *          timestamp. Must match an existing file.
+         * @param   [in] blockRows Rows collected before writing a block
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        TelemetryWriter(
+                const std::string& path,
+                const unsigned int fields,
+                const unsigned int blockRows=4096);
+
+        //! Write out any partial block and close the file
+        ~TelemetryWriter();
+
+        //! Append a row
+        /*!
+         * Timestamps must never go backwards, or readers could no longer
+         * search the file by time. A timestamp earlier than the last one
+         * appended, including those in the file already, is raised to it.
+         * A wall clock stepped back will therefore stamp its rows with the
+         * same time until it catches up.
+         *
+         * @param   [in] time Timestamp of the row. See timestamp().
+         * @param   [in] fields The fields of the row
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void append(const int64_t time, const int64_t* fields);
+
+        //! Write out the rows collected so far as a block
+        void flush();
+
+        //! Timestamp representation used in files
+        /*!
+         * @param   [in] time Wall clock time
+         * @return  Microseconds since the Unix epoch
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static int64_t timestamp(
+                const std::chrono::system_clock::time_point time
+                    =std::chrono::system_clock::now())
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                    time.time_since_epoch()).count();
+        }
+
+        //! Error indicating failure to open or map the file
+        class CantOpenStore: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to open telemetry store.";
+            }
+        };
+
+        //! Error indicating the file isn't a compatible telemetry store
+        class InvalidStore: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Invalid telemetry store.";
+            }
+        };
+
+    private:
+        //! Make sure the mapping can hold this many more bytes
+        void reserve(const size_t bytes);
+
+        const unsigned int m_fields;  //!< Fields per row
+        const unsigned int m_blockRows;  //!< Rows per block
+        int m_fd;  //!< File descriptor of the file
+        uint8_t* m_map;  //!< Mapping of the file
+        size_t m_capacity;  //!< Size of the mapping and file
+        int64_t m_last;  //!< Latest timestamp appended
+
+        //! Collected columns. The timestamp column comes first.
+        std::vector<std::vector<int64_t>> m_columns;
+
+        TelemetryWriter(const TelemetryWriter&);
+        TelemetryWriter& operator=(const TelemetryWriter&);
+    };
+
+    //! Reads a file written by TelemetryWriter
+    /*!
+     * The file is memory mapped and only the block headers are read on
+     * opening so this is quick regardless of size. Blocks are decoded as
+     * they are scanned.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class TelemetryReader
+    {
+    public:
+        //! Receives each row of a scan
+        /*!
+         * The fields pointer is only valid during the call.
+         */
+        typedef std::function<void(int64_t time, const int64_t* fields)>
+            Visitor;
+
+        //! Open and index a file
+        /*!
+         * @param   [in] path Path of the file
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        TelemetryReader(const std::string& path);
+
+        ~TelemetryReader();
+
+        //! Number of fields in a row, not counting the timestamp
+        unsigned int fields() const { return m_fields; }
+
+        //! Total number of rows in the file
+        size_t rows() const { return m_rows; }
+
+        //! Visit every row in a time range
+        /*!
+         * @param   [in] from Earliest timestamp to visit
+         * @param   [in] to Visit timestamps before this
+         * @param   [in] visit Called with each row in time order
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void scan(
+                const int64_t from,
+                const int64_t to,
+                const Visitor& visit) const;
+
+        //! Error indicating failure to open or map the file
+        class CantOpenStore: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to open telemetry store.";
+            }
+        };
+
+        //! Error indicating the file isn't a valid telemetry store
+        class InvalidStore: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Invalid telemetry store.";
+            }
+        };
+
+    private:
+        //! Where to find a block and what it covers
+        struct Block
+        {
+            int64_t first;  //!< Timestamp of the first row
+            int64_t last;  //!< Timestamp of the last row
+            size_t offset;  //!< Offset of the block header in the file
+        };
+
+        unsigned int m_fields;  //!< Fields per row
+        size_t m_rows;  //!< Total rows
+        int m_fd;  //!< File descriptor of the file
+        const uint8_t* m_map;  //!< Mapping of the file
+        size_t m_size;  //!< Size of the mapping
+        std::vector<Block> m_blocks;  //!< Index of blocks in time order
+
+        TelemetryReader(const TelemetryReader&);
+        TelemetryReader& operator=(const TelemetryReader&);
+    };
+}
+
+#endif
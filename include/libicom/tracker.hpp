@@ -0,0 +1,159 @@
+/*!
+ * @file       tracker.hpp
+ * @brief      Declares the Icom::Tracker class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACKER_HPP
+#define TRACKER_HPP
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "libicom/controller.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Continuously retunes a device to follow a changing frequency
+    /*!
+     * This is intended for Doppler correction. A thread of its own sends
+     * SetFrequency as often as the bus and its budgets allow. The frequency
+     * is only computed once the bus is available, for the time it will hit
+     * the wire, so updates never queue up and go stale. Changes smaller than
+     * a threshold are skipped to leave the bus for others.
+     *
+     * Frequencies below zero or beyond an unsigned int are clamped and ones
+     * that aren't a number are ignored. A failed update is counted and
+     * retried after a short back off.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Tracker
+    {
+    public:
+        //! Frequency in Hz the device should be on at a point in time
+        typedef std::function<double(Clock::time_point time)> Function;
+
+        //! Frequency in Hz at points in time
+        typedef std::vector<std::pair<Clock::time_point, double>> Table;
+
+        //! Start tracking
+        /*!
+         * @param   [in] controller Controller of the bus the device is on
+         * @param   [in] device The %Icom device to retune
+         * @param   [in] function Frequency to track
+         * @param   [in] threshold Smallest change in Hz worth an update
+         * @param   [in] client Client to attribute the updates to
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Tracker(
+                const Controller& controller,
+                const device_t& device,
+                const Function& function,
+                const double threshold=10,
+                const unsigned int client=0);
+
+        //! Stop tracking
+        ~Tracker();
+
+        //! Make a tracking function from a table
+        /*!
+         * The frequency is interpolated linearly between entries and held
+         * at the first and last entries outside of the table.
+         *
+         * @param   [in] table Entries in time order
+         * @return  Function to pass to the constructor
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        static Function interpolate(const Table& table);
+
+        //! Average rate of updates sent since starting
+        /*!
+         * @return  Updates per second
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double rate() const;
+
+        //! Root mean square tracking error since starting
+        /*!
+         * The error is the difference between the tracked frequency and the
+         * one last sent. It is sampled each time the tracker checks whether
+         * an update is needed, which is about once per frame time.
+         *
+         * @return  Error in Hz
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double error() const;
+
+        //! Largest tracking error since starting
+        /*!
+         * @return  Error in Hz
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        double maxError() const;
+
+        //! Number of updates that failed with an exception
+        unsigned long errors() const;
+
+        //! Milliseconds to wait after a failed update
+        static const unsigned int backoff=100;
+
+    private:
+        //! Body of the tracking thread
+        void run();
+
+        const Controller& m_controller;  //!< Controller of the bus
+        const device_t m_device;  //!< Device we retune
+        const Function m_function;  //!< Frequency to track
+        const double m_threshold;  //!< Smallest change worth an update
+        const unsigned int m_client;  //!< Client updates are attributed to
+        const Clock::time_point m_start;  //!< When tracking started
+
+        mutable std::mutex m_mutex;  //!< Guards the statistics
+        unsigned long m_updates;  //!< Updates sent
+        unsigned long m_errors;  //!< Updates failed
+        unsigned long m_samples;  //!< Error samples taken
+        double m_squaredError;  //!< Sum of the squares of the error samples
+        double m_maxError;  //!< Largest error sample
+
+        std::atomic<bool> m_running;  //!< Cleared to stop the thread
+        std::thread m_thread;  //!< The tracking thread
+
+        Tracker(const Tracker&);
+        Tracker& operator=(const Tracker&);
+    };
+}
+
+#endif
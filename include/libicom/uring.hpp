@@ -0,0 +1,165 @@
+/*!
+ * @file       uring.hpp
+ * @brief      Declares the Icom::Uring class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef URING_HPP
+#define URING_HPP
+
+#ifdef ICOM_IO_URING
+
+#include <exception>
+#include <cstdint>
+#include <cstddef>
+
+#include <linux/io_uring.h>
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Minimal io_uring submission and completion ring
+    /*!
+     * This talks to the kernel directly so doesn't need liburing. It is only
+     * built with ICOM_IO_URING defined, in which case the Controller uses it
+     * to do its serial port I/O. Writes queued for a frame are submitted
+     * together with the read of its reply so an exchange costs a single
+     * system call.
+     *
+     * A ring is not thread safe. The Controller only uses it with the bus
+     * held.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Uring
+    {
+    public:
+        //! Set up a ring
+        /*!
+         * @param   [in] entries Number of submission queue entries
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Uring(const unsigned int entries);
+
+        ~Uring();
+
+        //! Queue an operation on a file descriptor
+        /*!
+         * The buffer must stay valid until the operation completes. If the
+         * submission queue is full it is submitted first, so a chain of
+         * linked operations should be queued onto an empty ring.
+         *
+         * @param   [in] opcode IORING_OP_READ, IORING_OP_WRITE,
+         *          IORING_OP_ASYNC_CANCEL or IORING_OP_LINK_TIMEOUT
+         * @param   [in] fd File descriptor to operate on
+         * @param   [in] buffer Buffer to read into or write from. For a
+         *          linked timeout this is the __kernel_timespec.
+         * @param   [in] length Size of buffer. For a linked timeout this is 1.
+         * @param   [in] data Passed back with the completion
+         * @param   [in] flags IOSQE_IO_LINK to tie the next operation to this
+         *          one
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void prepare(
+                const uint8_t opcode,
+                const int fd,
+                const void* buffer,
+                const unsigned int length,
+                const uint64_t data,
+                const uint8_t flags=0);
+
+        //! Submit queued operations and wait for completions
+        /*!
+         * @param   [in] wait Number of completions to wait for
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void enter(const unsigned int wait);
+
+        //! Take a completion off the ring
+        /*!
+         * @param   [out] result Result of the operation as a system call
+         *          would return it
+         * @param   [out] data Data passed to prepare()
+         * @return  False if there were no completions.
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        bool reap(int& result, uint64_t& data);
+
+        //! Error indicating failure to set up the ring
+        class CantSetupRing: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to set up io_uring.";
+            }
+        };
+
+        //! Error indicating failure to submit to the ring
+        class EnterError: public std::exception
+        {
+            const char* what() const throw()
+            {
+                return "Unable to enter io_uring.";
+            }
+        };
+
+    private:
+        //! Unmap the rings and close the ring descriptor
+        void release();
+
+        int m_fd;  //!< File descriptor of the ring
+
+        void* m_sq;  //!< Mapping of the submission queue ring
+        size_t m_sqSize;  //!< Size of m_sq
+        void* m_cq;  //!< Mapping of the completion queue ring
+        size_t m_cqSize;  //!< Size of m_cq
+        io_uring_sqe* m_sqes;  //!< Mapping of submission queue entries
+        size_t m_sqesSize;  //!< Size of m_sqes
+
+        unsigned int* m_sqHead;  //!< Consumed by the kernel
+        unsigned int* m_sqTail;  //!< Produced by us
+        unsigned int m_sqMask;  //!< Mask from position to index
+        unsigned int m_sqEntries;  //!< Size of the submission queue
+        unsigned int* m_sqArray;  //!< Indices of submitted entries
+
+        unsigned int* m_cqHead;  //!< Consumed by us
+        unsigned int* m_cqTail;  //!< Produced by the kernel
+        unsigned int m_cqMask;  //!< Mask from position to index
+        io_uring_cqe* m_cqes;  //!< Completion queue entries
+
+        unsigned int m_queued;  //!< Entries queued but not yet submitted
+
+        Uring(const Uring&);
+        Uring& operator=(const Uring&);
+    };
+}
+
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+/*!
+ * @file       verifier.hpp
+ * @brief      Declares the Icom::Verifier class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFIER_HPP
+#define VERIFIER_HPP
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+
+#include "libicom/controller.hpp"
+
+//! Contains all elements for controlling %Icom devices
+namespace Icom
+{
+    //! Sends sets without waiting on acknowledgements and verifies them later
+    /*!
+     * Sets executed through this skip their acknowledgements (see
+     * Command_base::skipAcknowledgement()) so a batch of them costs no round
+     * trips. Once no further sets have been executed for a while, a thread
+     * of its own reads back the frequency, mode and offset of every device
+     * that was set in a single batch and reports any that didn't end up as
+     * expected.
+     *
+     * The selected %VFO can't be read back so it isn't verified.
+     *
+     * @date    October 19, 2026
+     * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+     */
+    class Verifier
+    {
+    public:
+        //! Called from the verifying thread for each device that is off
+        /*!
+         * Only the parts of the state that were set are known in expected.
+         * Parts that couldn't be read back are unknown in actual.
+         */
+        typedef std::function<void(
+                const device_t& device,
+                const RadioState& expected,
+                const RadioState& actual)> Callback;
+
+        //! Start the verifying thread
+        /*!
+         * @param   [in] controller Controller of the bus the devices are on
+         * @param   [in] mismatch Called for every device that is off
+         * @param   [in] delay How long after the last set to verify
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        Verifier(
+                const Controller& controller,
+                const Callback& mismatch,
+                const Clock::duration delay=std::chrono::milliseconds(100));
+
+        //! Stop the verifying thread without verifying what is left
+        ~Verifier();
+
+        //! Execute a batch of sets without waiting on acknowledgements
+        /*!
+         * This returns as soon as the sets are sent. Their status only
+         * means that they were sent.
+         *
+         * @param   [inout] sets Single exchange commands that set something
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void execute(Commands& sets);
+
+    private:
+        //! Body of the verifying thread
+        void run();
+
+        //! A device we have set and what we expect it to be
+        struct Expectation
+        {
+            device_t device;  //!< Device that was set
+            RadioState state;  //!< Expected state
+        };
+
+        //! Expectations indexed by device address
+        typedef std::map<uint8_t, Expectation> Expectations;
+
+        const Controller& m_controller;  //!< Controller of the bus
+        const Callback m_mismatch;  //!< Told about devices that are off
+        const Clock::duration m_delay;  //!< Time to verify after last set
+
+        std::mutex m_mutex;  //!< Guards everything below
+        std::condition_variable m_wake;  //!< Notified on sets and stopping
+        Expectations m_expectations;  //!< Devices still to verify
+        Clock::time_point m_due;  //!< When to verify
+        bool m_running;  //!< Cleared to stop the thread
+        std::thread m_thread;  //!< The verifying thread
+
+        Verifier(const Verifier&);
+        Verifier& operator=(const Verifier&);
+    };
+}
+
+#endif
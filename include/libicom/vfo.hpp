@@ -75,6 +75,20 @@ namespace Icom
         {
             return new VFO(dev);
         }
+
+        //! Record the %VFO change in the device state
+        /*!
+         * Changing the %VFO changes what the frequency, mode and offset are
+         * so they are invalidated.
+         *
+         * @param   [inout] state Cached state of our device
+         * @date    October 19, 2026
+         * @author  Eddie Carle &lt;eddie@isatec.ca&gt;
+         */
+        void update(RadioState& state) const;
+
+        //! Skip if the %VFO is already selected
+        bool suppress(const RadioState& state, const Clock::duration maxAge);
     private:
         //! Construct the command object to set the %VFO state
         /*!
@@ -0,0 +1,107 @@
+/*!
+ * @file       bandwidth.cpp
+ * @brief      Defines the Icom::Budget and Icom::Utilization classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/bandwidth.hpp"
+
+#include <algorithm>
+
+Icom::Budget::Budget(const double share, const Clock::duration burst):
+    m_share(share),
+    m_burst(burst),
+    m_tokens(burst),
+    m_last(Clock::now())
+{}
+
+Icom::Clock::time_point Icom::Budget::available() const
+{
+    if(m_tokens >= Clock::duration::zero())
+        return m_last;
+
+    return m_last + std::chrono::duration_cast<Clock::duration>(
+            -m_tokens / m_share);
+}
+
+void Icom::Budget::spend(
+        const Clock::duration cost,
+        const Clock::time_point now)
+{
+    if(now > m_last)
+    {
+        m_tokens = std::min(
+                m_burst,
+                m_tokens + std::chrono::duration_cast<Clock::duration>(
+                    (now-m_last) * m_share));
+        m_last = now;
+    }
+    m_tokens -= cost;
+}
+
+Icom::Utilization::Utilization(const Clock::duration window):
+    m_window(window),
+    m_start(Clock::now()),
+    m_current(Clock::duration::zero()),
+    m_previous(Clock::duration::zero())
+{}
+
+void Icom::Utilization::add(
+        const Clock::duration busy,
+        const Clock::time_point now)
+{
+    advance(now);
+    m_current += busy;
+}
+
+double Icom::Utilization::value(const Clock::time_point now)
+{
+    advance(now);
+
+    // Weight the previous window by how much of it is still in range
+    const double overlap = 1.0 - (double)(now-m_start).count()
+        / m_window.count();
+    return std::min(
+            1.0,
+            (m_current.count() + overlap*m_previous.count())
+                / m_window.count());
+}
+
+void Icom::Utilization::advance(const Clock::time_point now)
+{
+    if(now - m_start < m_window)
+        return;
+
+    if(now - m_start < 2*m_window)
+    {
+        m_previous = m_current;
+        m_start += m_window;
+    }
+    else
+    {
+        m_previous = Clock::duration::zero();
+        m_start = now;
+    }
+    m_current = Clock::duration::zero();
+}
@@ -25,35 +25,21 @@
  * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "bcd.hpp"
+#include "libicom/bcd.hpp"
 
-uint64_t Icom::getBCD(
+bool Icom::getBCD(
         const Buffer::const_iterator start,
-        const Buffer::const_iterator end)
+        const Buffer::const_iterator end,
+        uint64_t& number)
 {
-    if(end-start>10)
-        return 0;
+    const size_t size = end-start;
+    if(size > sizeof(uint64_t))
+        return false;
 
-    uint64_t number=0;
-    uint64_t multiplier=1;
-    uint64_t digit;
+    const uint64_t packed = size ? loadBCD(&*start, size) : 0;
 
-    for(Buffer::const_iterator byte=start; byte != end; ++byte)
-    {
-        digit = (*byte&0x0f);
-        if(digit>9)
-            return 0;
-        number += digit*(multiplier);
-        multiplier *= 10;
-        
-        digit = (*byte>>4);
-        if(digit>9)
-            return 0;
-        number += digit*(multiplier);
-        multiplier *= 10;
-    }
-
-    return number;
+    number = unpackBCD(packed);
+    return validBCD(packed);
 }
 
 void Icom::putBCD(
@@ -61,17 +47,9 @@ void Icom::putBCD(
         const Buffer::iterator end,
         uint64_t number)
 {
-    uint64_t divider=10;
-    unsigned char digit;
-
-    for(Buffer::iterator byte=start; byte!=end; ++byte)
-    {
-        digit = (unsigned char)(number%10);
-        *byte = digit&0x0f;
-        number /= divider;
+    const uint64_t packed = packBCD(number);
 
-        digit = (unsigned char)(number%10);
-        *byte |= digit<<4;
-        number /= divider;
-    }
+    const size_t size = end-start;
+    for(size_t i=0; i<size; ++i)
+        start[i] = bcdByte(packed, i);
 }
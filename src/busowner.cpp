@@ -0,0 +1,216 @@
+/*!
+ * @file       busowner.cpp
+ * @brief      Defines the Icom::BusOwner class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/busowner.hpp"
+
+#include <algorithm>
+
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+
+Icom::BusOwner::BusOwner(const Controller& controller):
+    m_controller(controller),
+    m_head(&m_stub),
+    m_tail(&m_stub),
+    m_wake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    m_running(true)
+{
+    if(m_wake == -1)
+        throw CantCreateWakeup();
+
+    m_thread = std::thread(&BusOwner::run, this);
+}
+
+Icom::BusOwner::~BusOwner()
+{
+    m_running = false;
+    wake();
+    m_thread.join();
+    close(m_wake);
+}
+
+std::future<void> Icom::BusOwner::submit(const Command& command)
+{
+    Node* const node = new Node;
+    node->command = command;
+    std::future<void> done = node->done.get_future();
+
+    push(node);
+    wake();
+
+    return done;
+}
+
+void Icom::BusOwner::setAffinity(const unsigned int cpu)
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if(pthread_setaffinity_np(m_thread.native_handle(), sizeof(cpus), &cpus))
+        throw CantTuneThread();
+}
+
+void Icom::BusOwner::setRealtime(const int priority)
+{
+    struct sched_param parameters;
+    parameters.sched_priority = priority;
+    if(pthread_setschedparam(
+                m_thread.native_handle(),
+                SCHED_FIFO,
+                &parameters))
+        throw CantTuneThread();
+}
+
+void Icom::BusOwner::lockMemory()
+{
+    if(mlockall(MCL_CURRENT | MCL_FUTURE))
+        throw CantTuneThread();
+}
+
+void Icom::BusOwner::push(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* const previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+Icom::BusOwner::Node* Icom::BusOwner::pop()
+{
+    Node* tail = m_tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if(tail == &m_stub)
+    {
+        if(next == nullptr)
+            return nullptr;
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if(next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+
+    // A push is half way done
+    if(tail != m_head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // The tail is the last node so put the stub behind it before taking it
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if(next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+void Icom::BusOwner::wake()
+{
+    const uint64_t one = 1;
+    if(write(m_wake, &one, sizeof(one))) {}
+}
+
+void Icom::BusOwner::run()
+{
+    Commands pending;
+    Commands completed;
+    std::vector<Node*> nodes;
+
+    while(true)
+    {
+        // Reset the wakeup before looking so that nothing pushed after this
+        // can be missed
+        uint64_t count;
+        if(read(m_wake, &count, sizeof(count))) {}
+
+        for(Node* node=pop(); node!=nullptr; node=pop())
+        {
+            nodes.push_back(node);
+            pending.push_back(node->command);
+        }
+
+        Clock::time_point next = Clock::time_point::max();
+        if(!pending.empty())
+        {
+            try
+            {
+                next = m_controller.step(pending, completed, m_wake);
+            }
+            catch(...)
+            {
+                // Whatever went wrong on the bus takes everything with it
+                for(Node* node: nodes)
+                {
+                    node->done.set_exception(std::current_exception());
+                    delete node;
+                }
+                nodes.clear();
+                pending.clear();
+                continue;
+            }
+
+            for(auto& command: completed)
+            {
+                const std::vector<Node*>::iterator node = std::find_if(
+                        nodes.begin(),
+                        nodes.end(),
+                        [&command](const Node* x)
+                        {
+                            return x->command == command;
+                        });
+                (*node)->done.set_value();
+                delete *node;
+                nodes.erase(node);
+            }
+            completed.clear();
+        }
+        else if(!m_running)
+            break;
+
+        // Sleep until the next step is due or there is more work
+        const Clock::time_point now = Clock::now();
+        if(next > now)
+        {
+            struct pollfd descriptor = {m_wake, POLLIN, 0};
+            int timeout = -1;
+            if(next != Clock::time_point::max())
+                timeout = (int)std::chrono::duration_cast<
+                    std::chrono::milliseconds>(next-now).count()+1;
+            poll(&descriptor, 1, timeout);
+        }
+    }
+}
@@ -62,6 +62,14 @@ class CommandFailed: public std::exception
     }
 };
 
+class CommandTimeout: public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Command timed out.";
+    }
+};
+
 class CommandParseError: public std::exception
 {
 public:
@@ -151,6 +159,9 @@ int main(int argc, char *argv[])
 
                         case Icom::FAIL:
                             throw CommandFailed();
+
+                        case Icom::TIMEOUT:
+                            throw CommandTimeout();
                     }
                     return 0;
                 }
@@ -195,6 +206,9 @@ int main(int argc, char *argv[])
 
                         case Icom::FAIL:
                             throw CommandFailed();
+
+                        case Icom::TIMEOUT:
+                            throw CommandTimeout();
                     }
                     return 0;
                 }
@@ -254,25 +268,54 @@ int main(int argc, char *argv[])
 
                         case Icom::FAIL:
                             throw CommandFailed();
+
+                        case Icom::TIMEOUT:
+                            throw CommandTimeout();
                     }
                     return 0;
                 }
                 else if(arguments.size()==1)
                 {
                     const int offset=std::stoi(arguments.front());
-                    command.reset(Icom::SetDuplex::make(device, offset));
-                    break;
+                    Icom::Commands commands(
+                            Icom::duplexCommands(device, offset));
+                    controller.execute(commands);
+                    for(const auto& command: commands)
+                        switch(command->status())
+                        {
+                            case Icom::SUCCESS:
+                                break;
+                            case Icom::PARSEERROR:
+                                throw CommandParseError(command->resultData());
+
+                            case Icom::INCOMPLETE:
+                                throw CommandIncomplete();
+
+                            case Icom::FAIL:
+                                throw CommandFailed();
+
+                            case Icom::TIMEOUT:
+                                throw CommandTimeout();
+                        }
+                    std::cout << "Command Succeeded" << std::endl;
+                    return 0;
                 }
             }
 
             case SQUELCHHOLD:
             {
-                if(arguments.size() == 1)
+                if(arguments.size() == 1 || arguments.size() == 2)
                 {
+                    const Icom::squelchState_t state=
+                        Icom::squelchStateFromName(arguments.front());
+                    std::chrono::milliseconds timeout(0);
+                    if(arguments.size() == 2)
+                        timeout = std::chrono::milliseconds(
+                                std::stoul(arguments.back()));
                     command.reset(Icom::SquelchHold::make(
                                 device,
-                                Icom::squelchStateFromName(arguments.front())
-                                ));
+                                state,
+                                timeout));
                     controller.execute(command);
                     switch(command->status())
                     {
@@ -290,6 +333,9 @@ int main(int argc, char *argv[])
 
                         case Icom::FAIL:
                             throw CommandFailed();
+
+                        case Icom::TIMEOUT:
+                            throw CommandTimeout();
                     }
                     return 0;
                 }
@@ -313,6 +359,9 @@ int main(int argc, char *argv[])
 
             case Icom::FAIL:
                 throw CommandFailed();
+
+            case Icom::TIMEOUT:
+                throw CommandTimeout();
         }
 
         return 0;
@@ -27,18 +27,37 @@
 
 #include "libicom/command.hpp"
 
-Icom::Command_base::Command_base(const device_t& dev, bool reply):
+const uint8_t Icom::Command_base::footer;
+const uint8_t Icom::Command_base::header;
+const uint8_t Icom::Command_base::broadcast;
+
+Icom::Command_base::Command_base(
+        const device_t& dev,
+        bool reply,
+        priority_t priority):
     device(dev),
     m_reply(reply),
-    m_status(INCOMPLETE)
+    m_status(INCOMPLETE),
+    m_priority(priority),
+    m_client(0),
+    m_target(Clock::time_point::max()),
+    m_skipAcknowledgement(false)
 {
     m_command.reserve(bufferReserveSize);
     m_result.reserve(bufferReserveSize);
 }
 
+void Icom::Command_base::reset()
+{
+    m_status = INCOMPLETE;
+    m_result.clear();
+    m_sent = Clock::time_point();
+    m_due = timed()?m_target:Clock::time_point();
+}
+
 bool Icom::Command_base::complete()
 {
-    if(!m_reply)
+    if(!awaitsReply())
         m_status = SUCCESS;
     else if(m_result.size() == 1)
     {
@@ -26,19 +26,49 @@
  */
 
 #include "libicom/controller.hpp"
+#include "libicom/frequency.hpp"
+#include "libicom/plan.hpp"
+
+#include <cerrno>
+#include <algorithm>
+#include <limits>
+#include <thread>
 
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <linux/serial.h>
+
+const size_t Icom::Controller::framing;
 
 Icom::Controller::Controller(
         const std::string& port,
         unsigned int baudRate,
         uint8_t address):
     m_fd(-1),
-    m_address(address)
+    m_timer(-1),
+    m_inputStart(0),
+    m_inputEnd(0),
+    m_address(address),
+    m_sequence(0),
+    m_rejections(0),
+    m_maxAge(Clock::duration::zero()),
+    m_suppressAge(Clock::duration::zero()),
+    m_lead(std::chrono::milliseconds(20)),
+    m_baudRate(baudRate),
+    m_utilization(std::chrono::seconds(1)),
+    m_scheduler(std::chrono::milliseconds(250))
 {
+#ifdef ICOM_IO_URING
+    // Set up the ring before we hold any descriptors so failing here leaves
+    // nothing to clean up
+    m_ring.reset(new Uring(8));
+    m_output.reserve(Command_base::bufferReserveSize);
+#endif
+
     m_fd = open(port.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
     if(m_fd == -1)
         throw CantOpenPort();
@@ -78,7 +108,9 @@ Icom::Controller::Controller(
             rate=B19200;
             break;
         default:
-            InvalidBaudRate();
+            close(m_fd);
+            m_fd=-1;
+            throw InvalidBaudRate();
     }
     cfsetispeed(&options, rate);
     cfsetospeed(&options, rate);
@@ -94,15 +126,31 @@ Icom::Controller::Controller(
             HUPCL                                   // Don't mess with the DTR
             );
     options.c_cflag |= (CLOCAL | CREAD | CS8 | IGNPAR);
-    options.c_cc[VTIME] = 2;                      // Timeout our reads in 200ms
-    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;                      // Return from reads as soon
+    options.c_cc[VMIN] = 1;                       // as a byte arrives
     tcsetattr(m_fd, TCSANOW, &options);
 
+    // Nobody else may open the port while we have it
+    ioctl(m_fd, TIOCEXCL);
+
+    // Have the driver pass received bytes on immediately rather than holding
+    // them back to batch them. Not all drivers support this.
+    struct serial_struct serial;
+    if(ioctl(m_fd, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(m_fd, TIOCSSERIAL, &serial);
+    }
+
     // Enable the DTR
     int lineData;
     ioctl(m_fd, TIOCMGET, &lineData);
     lineData |= TIOCM_DTR;
     ioctl(m_fd, TIOCMSET, &lineData);
+
+    // Steady clock is the monotonic clock so we can wake on its time points.
+    // Without the timer we fall back to millisecond poll timeouts.
+    m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
 }
 
 Icom::Controller::~Controller()
@@ -115,105 +163,998 @@ Icom::Controller::~Controller()
         ioctl(m_fd, TIOCMSET, &lineData);
         close(m_fd);
     }
+    if(m_timer != -1)
+        close(m_timer);
 }
 
 void Icom::Controller::execute(Command& command) const
 {
-    bool notForUs=false;
+    if(recall(*command))
+        return;
+
+    if(command->readOnly() && !command->timed())
+    {
+        coalesce(*command);
+        return;
+    }
 
-    do
+    const std::vector<Command_base*> pending(1, command.get());
+    approach(pending);
+    while(true)
     {
-        // Send the command
-        if(!notForUs)
         {
-            const Buffer header={
-                    Command_base::header,
-                    Command_base::header,
-                    command->device.address,
-                    m_address};
-            put(header);
-            put(command->commandData());
-            put(Command_base::footer);
+            const Scheduler::Ticket ticket(
+                    m_scheduler,
+                    command->priority(),
+                    command->target());
+            if(exchange(*command))
+                return;
         }
+        rest(pending);
+    }
+}
+
+void Icom::Controller::execute(Commands& commands) const
+{
+    std::vector<Command_base*> pending;
+    pending.reserve(commands.size());
+    for(auto& command: commands)
+        pending.push_back(command.get());
+
+    pending.erase(
+            std::remove_if(
+                pending.begin(),
+                pending.end(),
+                [this](Command_base* command) { return recall(*command); }),
+            pending.end());
+
+    approach(pending);
+    while(!pending.empty())
+        if(!burst(pending))
+            rest(pending);
+}
 
-        if(command->m_reply)
+bool Icom::Controller::burst(
+        std::vector<Command_base*>& pending,
+        const int wake) const
+{
+    priority_t priority = BACKGROUND;
+    for(auto command: pending)
+        priority = std::min(priority, command->priority());
+
+    const Scheduler::Ticket ticket(m_scheduler, priority, target(pending));
+    if(!idle(pending, wake))
+        return false;
+
+    volley(pending);
+    return true;
+}
+
+void Icom::Controller::volley(
+        std::vector<Command_base*>& pending,
+        const bool budgeted) const
+{
+    std::vector<Command_base*> sent;
+    sent.reserve(pending.size());
+    std::vector<std::pair<Command_base*, unsigned long>> awaiting;
+    awaiting.reserve(pending.size());
+    Buffer reply;
+    reply.reserve(Command_base::bufferReserveSize);
+
+    // Send everything that is due in one burst
+    const Clock::time_point now = Clock::now();
+    size_t bytes = 0;
+    for(auto command: pending)
+        if((budgeted ? ready(*command) : command->due()) <= now)
         {
-            // Get the reply
-            notForUs=false;
-            unsigned int state=0;
-            uint8_t buffer;
-            command->resultData().clear();
-            while(state<5)
+            const unsigned long sequence = send(*command);
+            bytes += command->commandData().size()+framing;
+            sent.push_back(command);
+            if(command->awaitsReply())
+                awaiting.push_back(std::make_pair(command, sequence));
+        }
+    if(awaiting.empty())
+        flush();
+
+    // Match each reply to the oldest command waiting on that device. Each
+    // frame that turns up gives the devices more time to reply.
+    Clock::time_point deadline =
+        Clock::now() + wireTime(bytes) + replyTimeout();
+    while(!awaiting.empty())
+    {
+        if(!arriving(deadline))
+        {
+            for(auto& waiter: awaiting)
             {
-                buffer=get();
+                giveUp(*waiter.first);
+                sent.erase(std::find(sent.begin(), sent.end(), waiter.first));
+                pending.erase(std::find(
+                            pending.begin(),
+                            pending.end(),
+                            waiter.first));
+            }
+            break;
+        }
+
+        uint8_t to;
+        uint8_t from;
+        receive(reply, to, from);
+        deadline = Clock::now() + replyTimeout();
+        if(to != m_address)
+        {
+            dispatch(pending, reply, to, from);
+            continue;
+        }
 
-                switch(state)
+        const auto waiter = std::find_if(
+                awaiting.begin(),
+                awaiting.end(),
+                [from](const std::pair<Command_base*, unsigned long>& waiter)
                 {
-                    case 0:
-                    case 1:
-                        if(buffer!=Command_base::header)
-                            throw InvalidReply();
-                        ++state;
-                        break;
-                    case 2:
-                        if(buffer!=m_address)
-                            notForUs=true;
-                        ++state;
-                        break;
-                    case 3:
-                        if(buffer!=command->device.address)
-                            notForUs=true;
-                        ++state;
-                        break;
-                    case 4:
-                        if(buffer != Command_base::footer)
-                            command->resultData().push_back(buffer);
-                        else
-                            ++state;
-                        break;
-                }
+                    return waiter.first->device.address == from;
+                });
+        if(waiter == awaiting.end())
+        {
+            stray(reply, from);
+            continue;
+        }
+        if(stray(reply, from, waiter->second))
+            continue;
+
+        charge(*waiter->first, reply.size()+framing);
+        waiter->first->resultData().swap(reply);
+        awaiting.erase(waiter);
+    }
+
+    // Anything still incomplete stays pending
+    for(auto command: sent)
+        if(complete(*command))
+            pending.erase(std::find(pending.begin(), pending.end(), command));
+}
+
+bool Icom::Controller::transact(Commands& steps) const
+{
+    // The cached state can't answer for steps that follow others changing
+    // it so everything goes to the device
+    std::vector<Command_base*> pending;
+    pending.reserve(steps.size());
+    priority_t priority = BACKGROUND;
+    for(auto& step: steps)
+    {
+        pending.push_back(step.get());
+        priority = std::min(priority, step->priority());
+    }
+
+    if(!pending.empty())
+    {
+        // Wait off the bus until the budgets are out of debt. Once we have
+        // the bus they no longer hold anything back so no step can slip
+        // behind others.
+        Clock::time_point latest;
+        for(auto command: pending)
+            latest = std::max(latest, ready(*command));
+        approach(pending);
+        std::this_thread::sleep_until(latest);
+
+        const Scheduler::Ticket ticket(
+                m_scheduler,
+                priority,
+                target(pending));
+
+        while(!pending.empty())
+            if(idle(pending, -1, true, false))
+                volley(pending, false);
+    }
+
+    for(auto& step: steps)
+        if(step->status() != SUCCESS)
+            return false;
+    return true;
+}
+
+void Icom::Controller::hop(
+        const uint8_t* frame,
+        const priority_t priority,
+        const unsigned int client) const
+{
+    const size_t size = FrequencyPlan::frameSize;
+    if(frame[0] != Command_base::header
+            || frame[1] != Command_base::header
+            || frame[3] != m_address
+            || !SetFrequency::valid(frame+4)
+            || frame[size-1] != Command_base::footer)
+        throw InvalidFrame();
+    const uint8_t address = frame[2];
+
+    while(true)
+    {
+        // Wait out any budget off the bus
+        const Clock::time_point due = ready(client, address);
+        if(due > Clock::now())
+            std::this_thread::sleep_until(due);
+
+        const Scheduler::Ticket ticket(m_scheduler, priority);
+        if(ready(client, address) > Clock::now())
+            continue;
+
+        put(frame, size);
+        flush();
+        ++m_sequence;
+        const Stray stray = {m_sequence, Clock::now()};
+        m_strays[address].push_back(stray);
+        charge(client, address, size);
+        meter(size);
+        break;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_states[address].frequency.assume(SetFrequency::frequency(frame+4));
+}
+
+bool Icom::Controller::step(Command& command) const
+{
+    if(recall(*command))
+        return true;
+
+    approach(std::vector<Command_base*>(1, command.get()));
+    const Scheduler::Ticket ticket(
+            m_scheduler,
+            command->priority(),
+            command->target());
+    return exchange(*command);
+}
+
+Icom::Clock::time_point Icom::Controller::step(
+        Commands& pending,
+        Commands& completed,
+        const int wake) const
+{
+    // Complete whatever we can without the bus
+    for(auto it=pending.begin(); it!=pending.end();)
+        if((*it)->sent() == Clock::time_point() && recall(**it))
+        {
+            completed.push_back(*it);
+            it = pending.erase(it);
+        }
+        else
+            ++it;
+
+    Clock::duration lead;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        lead = m_lead;
+    }
+
+    // Timed commands only join in once it is time to claim the bus
+    const Clock::time_point now = Clock::now();
+    Clock::time_point next = Clock::time_point::max();
+    std::vector<Command_base*> eligible;
+    eligible.reserve(pending.size());
+    for(auto& command: pending)
+        if(!command->timed() || command->target()-lead <= now)
+            eligible.push_back(command.get());
+        else
+            next = std::min(next, command->target()-lead);
+
+    if(eligible.empty())
+        return next;
+
+    const std::vector<Command_base*> offered(eligible);
+    if(!burst(eligible, wake))
+    {
+        rest(eligible, wake);
+        return now;
+    }
+
+    for(auto command: offered)
+        if(std::find(eligible.begin(), eligible.end(), command)
+                == eligible.end())
+        {
+            const Commands::iterator it = std::find_if(
+                    pending.begin(),
+                    pending.end(),
+                    [command](const Command& x) { return x.get() == command; });
+            completed.push_back(*it);
+            pending.erase(it);
+        }
+
+    return now;
+}
+
+void Icom::Controller::coalesce(Command_base& command) const
+{
+    const Flights::key_type key(
+            command.device.address,
+            command.client(),
+            command.commandData());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Flights::iterator flight = m_flights.find(key);
+
+    if(flight != m_flights.end())
+    {
+        // Somebody is already asking the device this so wait on their reply
+        const std::shared_ptr<const Flight> leader(flight->second);
+        m_landed.wait(lock, [&leader]() { return leader->landed; });
+        lock.unlock();
+
+        if(leader->error)
+            std::rethrow_exception(leader->error);
+        command.resultData() = leader->result;
+        complete(command);
+        return;
+    }
+
+    const std::shared_ptr<Flight> leader(new Flight);
+    m_flights.insert(Flights::value_type(key, leader));
+    lock.unlock();
+
+    try
+    {
+        const std::vector<Command_base*> pending(1, &command);
+        while(true)
+        {
+            {
+                const Scheduler::Ticket ticket(
+                        m_scheduler,
+                        command.priority());
+                if(exchange(command))
+                    break;
+            }
+            rest(pending);
+        }
+        leader->result = command.resultData();
+    }
+    catch(...)
+    {
+        leader->error = std::current_exception();
+    }
+
+    lock.lock();
+    leader->landed = true;
+    m_flights.erase(key);
+    lock.unlock();
+    m_landed.notify_all();
+
+    if(leader->error)
+        std::rethrow_exception(leader->error);
+}
+
+bool Icom::Controller::exchange(Command_base& command) const
+{
+    const std::vector<Command_base*> pending(1, &command);
+    if(!idle(pending))
+        return false;
+
+    const unsigned long sequence = send(command);
+
+    if(!command.awaitsReply())
+        flush();
+    else
+    {
+        // Skip anything not sent from the device to us. This includes the
+        // echo of our own frame.
+        Clock::time_point deadline = Clock::now()
+            + wireTime(command.commandData().size()+framing)
+            + replyTimeout();
+        uint8_t to;
+        uint8_t from;
+        while(true)
+        {
+            if(!arriving(deadline))
+            {
+                giveUp(command);
+                return true;
+            }
+
+            receive(command.resultData(), to, from);
+            deadline = Clock::now() + replyTimeout();
+            if(to == m_address && from == command.device.address)
+            {
+                if(stray(command.resultData(), from, sequence))
+                    continue;
+                charge(command, command.resultData().size()+framing);
+                break;
+            }
+            dispatch(pending, command.resultData(), to, from);
+        }
+    }
+
+    return complete(command);
+}
+
+bool Icom::Controller::recall(Command_base& command) const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_maxAge == Clock::duration::zero()
+                && m_suppressAge == Clock::duration::zero())
+            return false;
+    }
+
+    // Whoever holds the bus passes on transceive frames as they read it
+    {
+        const Scheduler::Ticket ticket(m_scheduler, std::try_to_lock);
+        if(ticket.held())
+            drain();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const RadioState& state = m_states[command.device.address];
+    return (m_maxAge != Clock::duration::zero()
+                && command.recall(state, m_maxAge))
+        || (m_suppressAge != Clock::duration::zero()
+                && command.suppress(state, m_suppressAge));
+}
+
+void Icom::Controller::drain() const
+{
+    const std::vector<Command_base*> none;
+    Buffer data;
+    while(true)
+    {
+        struct pollfd descriptor = {m_fd, POLLIN, 0};
+        if(m_inputStart == m_inputEnd && poll(&descriptor, 1, 0) <= 0)
+            return;
+
+        uint8_t to;
+        uint8_t from;
+        receive(data, to, from);
+        dispatch(none, data, to, from);
+    }
+}
+
+bool Icom::Controller::complete(Command_base& command) const
+{
+    if(!command.complete())
+        return false;
+
+    if(command.status() == SUCCESS)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RadioState& state = m_states[command.device.address];
+
+        // Without the acknowledgement we can't know if it took
+        if(command.m_reply && !command.awaitsReply())
+            state.invalidate();
+        else
+            command.update(state);
+    }
+    return true;
+}
+
+bool Icom::Controller::stray(
+        const Buffer& data,
+        const uint8_t from,
+        const unsigned long before) const
+{
+    if(data.size() != 1 || (data.front() != 0xfb && data.front() != 0xfa))
+        return false;
+
+    const auto strays = m_strays.find(from);
+    if(strays == m_strays.end())
+        return false;
+    std::deque<Stray>& queue = strays->second;
+
+    // Stop expecting acknowledgements the device must have dropped
+    const Clock::time_point now = Clock::now();
+    while(!queue.empty() && now-queue.front().time > strayTimeout())
+        queue.pop_front();
+
+    // Anything sent after the frame awaiting a reply is acknowledged after
+    // that reply
+    bool matched = false;
+    if(!queue.empty() && queue.front().sequence < before)
+    {
+        if(data.front() == 0xfa)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_rejections;
+        }
+        queue.pop_front();
+        matched = true;
+    }
+
+    // The emptied queue is kept for the device's next skipped
+    // acknowledgement
+    return matched;
+}
+
+void Icom::Controller::giveUp(Command_base& command) const
+{
+    command.abandon();
+
+    // The device has been silent for longer than we expect any skipped
+    // acknowledgement so none of them are still coming
+    m_strays.erase(command.device.address);
+
+    if(command.readOnly())
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_states[command.device.address].invalidate();
+}
+
+bool Icom::Controller::arriving(const Clock::time_point deadline) const
+{
+    if(m_inputStart != m_inputEnd)
+        return true;
+
+#ifdef ICOM_IO_URING
+    while(true)
+    {
+        const size_t received = transfer(true, deadline);
+        if(received)
+        {
+            m_inputStart = 0;
+            m_inputEnd = received;
+            return true;
+        }
+        if(Clock::now() >= deadline)
+            return false;
+    }
+#else
+    flush();
+    while(true)
+    {
+        const Clock::time_point now = Clock::now();
+        if(now >= deadline)
+            return false;
+
+        struct pollfd descriptor = {m_fd, POLLIN, 0};
+        const int timeout = (int)
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline-now).count()+1;
+        if(poll(&descriptor, 1, timeout) > 0)
+            return true;
+    }
+#endif
+}
+
+bool Icom::Controller::idle(
+        const std::vector<Command_base*>& commands,
+        const int wake,
+        const bool keep,
+        const bool budgeted) const
+{
+    // Timed commands hold on to the bus so they can hit their target
+    const bool timed = keep || target(commands) != Clock::time_point::max();
+
+    Buffer data;
+    while(true)
+    {
+        Clock::time_point due = Clock::time_point::max();
+        for(auto command: commands)
+            due = std::min(
+                    due,
+                    budgeted ? ready(*command) : command->due());
+
+        const Clock::time_point now = Clock::now();
+        if(due <= now)
+            return true;
+
+        // Don't sit on the bus while others want it
+        if(!timed && m_scheduler.contended())
+            return false;
+
+        // Frames already read in won't show up in a poll
+        if(m_inputStart != m_inputEnd)
+        {
+            uint8_t to;
+            uint8_t from;
+            receive(data, to, from);
+            dispatch(commands, data, to, from);
+            continue;
+        }
 
-                // We don't want to recieve a giant reply
-                if(command->resultData().size() >= Command_base::bufferReserveSize)
-                    throw BufferOverflow();
+        // Listen to the bus while we wait so that transceive frames can
+        // bring a command forward. The timer wakes us exactly when due.
+        // Negative descriptors are ignored by poll().
+        struct pollfd descriptors[3] = {
+            {m_fd, POLLIN, 0},
+            {m_timer, POLLIN, 0},
+            {timed ? -1 : wake, POLLIN, 0}};
+        Clock::duration wait = std::min<Clock::duration>(
+                due-now,
+                idleSlice());
+        if(m_timer != -1 && due-now <= idleSlice())
+        {
+            const auto sinceEpoch = due.time_since_epoch();
+            const auto seconds =
+                std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+            struct itimerspec expiry = {{0, 0}, {0, 0}};
+            expiry.it_value.tv_sec = seconds.count();
+            expiry.it_value.tv_nsec =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        sinceEpoch-seconds).count();
+            timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &expiry, nullptr);
+
+            // Only a safety net now
+            wait += idleSlice();
+        }
+        const int timeout = (int)
+            std::chrono::duration_cast<std::chrono::milliseconds>(wait)
+            .count()+1;
+
+        if(poll(descriptors, 3, timeout) > 0)
+        {
+            if(descriptors[2].revents & POLLIN)
+                return false;
+            if(descriptors[1].revents & POLLIN)
+            {
+                uint64_t expirations;
+                if(read(m_timer, &expirations, sizeof(expirations)) < 0)
+                    throw ReadError();
+            }
+            if(descriptors[0].revents & POLLIN)
+            {
+                uint8_t to;
+                uint8_t from;
+                receive(data, to, from);
+                dispatch(commands, data, to, from);
             }
         }
+    }
+}
+
+void Icom::Controller::rest(
+        const std::vector<Command_base*>& commands,
+        const int wake) const
+{
+    Clock::time_point due = Clock::time_point::max();
+    for(auto command: commands)
+        due = std::min(due, ready(*command));
 
-    } while(notForUs || !command->complete());
+    const Clock::time_point now = Clock::now();
+    if(due <= now)
+        return;
+
+    const Clock::duration wait = std::min<Clock::duration>(
+            due-now,
+            idleSlice());
+    if(wake < 0)
+        std::this_thread::sleep_for(wait);
+    else
+    {
+        struct pollfd descriptor = {wake, POLLIN, 0};
+        poll(
+                &descriptor,
+                1,
+                (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                    wait).count()+1);
+    }
+}
+
+void Icom::Controller::approach(
+        const std::vector<Command_base*>& commands) const
+{
+    Clock::duration lead;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        lead = m_lead;
+    }
+
+    const Clock::time_point deadline = target(commands);
+    if(deadline != Clock::time_point::max())
+        std::this_thread::sleep_until(deadline-lead);
+}
+
+Icom::Clock::time_point Icom::Controller::ready(
+        const unsigned int client,
+        const uint8_t address) const
+{
+    Clock::time_point ready;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto budget = m_clientBudgets.find(client);
+    if(budget != m_clientBudgets.end())
+        ready = std::max(ready, budget->second.available());
+    const auto device = m_deviceBudgets.find(address);
+    if(device != m_deviceBudgets.end())
+        ready = std::max(ready, device->second.available());
+
+    return ready;
+}
+
+void Icom::Controller::charge(
+        const unsigned int client,
+        const uint8_t address,
+        const size_t bytes) const
+{
+    const Clock::duration cost = wireTime(bytes);
+    const Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto budget = m_clientBudgets.find(client);
+    if(budget != m_clientBudgets.end())
+        budget->second.spend(cost, now);
+    const auto device = m_deviceBudgets.find(address);
+    if(device != m_deviceBudgets.end())
+        device->second.spend(cost, now);
+}
+
+void Icom::Controller::meter(const size_t bytes) const
+{
+    const Clock::duration busy = wireTime(bytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_utilization.add(busy, Clock::now());
+}
+
+void Icom::Controller::limitClient(
+        const unsigned int client,
+        const double share,
+        const Clock::duration burst)
+{
+    if(!(share > 0))
+        throw InvalidShare();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_clientBudgets.erase(client);
+    if(share < 1)
+        m_clientBudgets.insert(std::make_pair(client, Budget(share, burst)));
+}
+
+void Icom::Controller::limitDevice(
+        const device_t& device,
+        const double share,
+        const Clock::duration burst)
+{
+    if(!(share > 0))
+        throw InvalidShare();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deviceBudgets.erase(device.address);
+    if(share < 1)
+        m_deviceBudgets.insert(
+                std::make_pair(device.address, Budget(share, burst)));
+}
+
+Icom::Clock::time_point Icom::Controller::target(
+        const std::vector<Command_base*>& commands)
+{
+    Clock::time_point earliest = Clock::time_point::max();
+    for(auto command: commands)
+        earliest = std::min(earliest, command->target());
+    return earliest;
+}
+
+void Icom::Controller::dispatch(
+        const std::vector<Command_base*>& commands,
+        const Buffer& data,
+        const uint8_t to,
+        const uint8_t from) const
+{
+    // Stray acknowledgements are only ever sent to us
+    if(to == m_address)
+        stray(data, from);
+    if(to != Command_base::broadcast)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states[from].transceive(data);
+    }
+
+    for(auto command: commands)
+        if(command->device.address == from)
+            command->transceive(data);
+}
+
+unsigned long Icom::Controller::send(Command_base& command) const
+{
+    // Assemble the whole frame so it goes out in a single write
+    Buffer frame={
+            Command_base::header,
+            Command_base::header,
+            command.device.address,
+            m_address};
+    frame.insert(
+            frame.end(),
+            command.commandData().begin(),
+            command.commandData().end());
+    frame.push_back(Command_base::footer);
+
+    command.transmitted(Clock::now());
+    put(frame.data(), frame.size());
+    ++m_sequence;
+    if(command.m_reply && !command.awaitsReply())
+    {
+        const Stray stray = {m_sequence, Clock::now()};
+        m_strays[command.device.address].push_back(stray);
+    }
+    charge(command, frame.size());
+    meter(frame.size());
+    return m_sequence;
+}
+
+void Icom::Controller::receive(Buffer& data, uint8_t& to, uint8_t& from) const
+{
+    data.clear();
+
+    if(get() != Command_base::header || get() != Command_base::header)
+        throw InvalidReply();
+
+    to = get();
+    from = get();
+
+    for(uint8_t byte=get(); byte != Command_base::footer; byte=get())
+    {
+        // We don't want to recieve a giant reply
+        if(data.size() >= Command_base::bufferReserveSize)
+            throw BufferOverflow();
+        data.push_back(byte);
+    }
+
+    // Our own frames are metered as they are sent
+    if(from != m_address)
+        meter(data.size()+framing);
 }
 
 uint8_t Icom::Controller::get() const
 {
-    uint8_t x;
-    ssize_t n=0;
-    while(n==0)
-        n = read(m_fd, &x, 1);
-    if(n < 0)
-        throw ReadError();
-    return x;
+    // Take everything available in one read and hand it out byte by byte
+    if(m_inputStart == m_inputEnd)
+    {
+#ifdef ICOM_IO_URING
+        size_t n=0;
+        while(n==0)
+            n = transfer(true);
+#else
+        ssize_t n=0;
+        while(n==0)
+            n = read(m_fd, m_input.data(), m_input.size());
+        if(n < 0)
+            throw ReadError();
+#endif
+        m_inputStart = 0;
+        m_inputEnd = n;
+    }
+    return m_input[m_inputStart++];
 }
 
-void Icom::Controller::put(const Buffer data) const
+void Icom::Controller::put(const uint8_t* data, const size_t size) const
 {
+#ifdef ICOM_IO_URING
+    m_output.insert(m_output.end(), data, data+size);
+#else
     size_t position=0;
     ssize_t n;
-    while(position < data.size())
+    while(position < size)
     {
         n = write(
                 m_fd, 
-                &data.front()+position,
-                data.size()-position);
+                data+position,
+                size-position);
         if(n < 0)
             throw WriteError();
         position += n;
     }
+#endif
 }
 
-void Icom::Controller::put(const uint8_t byte) const
+void Icom::Controller::flush() const
 {
-    ssize_t n=0;
-    while(n==0)
-        n = write(m_fd, &byte, 1);
-    if(n < 0)
+#ifdef ICOM_IO_URING
+    if(!m_output.empty())
+        transfer(false);
+#endif
+}
+
+#ifdef ICOM_IO_URING
+size_t Icom::Controller::transfer(
+        const bool reading,
+        const Clock::time_point deadline) const
+{
+    enum: uint64_t {WRITE, READ, CANCEL, TIMEOUT};
+    const bool bounded = reading && deadline != Clock::time_point::max();
+
+    unsigned int outstanding = 0;
+    if(!m_output.empty())
+    {
+        m_ring->prepare(
+                IORING_OP_WRITE,
+                m_fd,
+                m_output.data(),
+                m_output.size(),
+                WRITE);
+        ++outstanding;
+    }
+    if(reading)
+    {
+        m_ring->prepare(
+                IORING_OP_READ,
+                m_fd,
+                m_input.data(),
+                m_input.size(),
+                READ,
+                bounded?IOSQE_IO_LINK:0);
+        ++outstanding;
+    }
+
+    // The kernel holds on to the timeout until it completes
+    struct __kernel_timespec timeout = {0, 0};
+    if(bounded)
+    {
+        const std::chrono::nanoseconds remaining = std::max(
+                std::chrono::nanoseconds::zero(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline-Clock::now()));
+        timeout.tv_sec = remaining.count()/1000000000;
+        timeout.tv_nsec = remaining.count()%1000000000;
+        m_ring->prepare(
+                IORING_OP_LINK_TIMEOUT,
+                -1,
+                &timeout,
+                1,
+                TIMEOUT);
+        ++outstanding;
+    }
+
+    // Every submission must complete before we return or throw. The kernel
+    // would otherwise go on writing into m_input after we've unwound.
+    bool writeFailed = false;
+    bool readFailed = false;
+    bool readPending = reading;
+    size_t received = 0;
+    while(outstanding)
+    {
+        m_ring->enter(outstanding);
+
+        int result;
+        uint64_t data;
+        while(m_ring->reap(result, data))
+        {
+            --outstanding;
+            if(data == WRITE)
+            {
+                if(result <= 0)
+                {
+                    writeFailed = true;
+                    if(readPending)
+                    {
+                        m_ring->prepare(
+                                IORING_OP_ASYNC_CANCEL,
+                                -1,
+                                reinterpret_cast<const void*>(READ),
+                                0,
+                                CANCEL);
+                        ++outstanding;
+                    }
+                    continue;
+                }
+
+                // Resubmit whatever a short write left behind
+                m_output.erase(m_output.begin(), m_output.begin()+result);
+                if(!m_output.empty())
+                {
+                    m_ring->prepare(
+                            IORING_OP_WRITE,
+                            m_fd,
+                            m_output.data(),
+                            m_output.size(),
+                            WRITE);
+                    ++outstanding;
+                }
+            }
+            else if(data == READ)
+            {
+                readPending = false;
+                if(result >= 0)
+                    received = result;
+                else if(result != -ECANCELED && result != -EINTR)
+                    readFailed = true;
+            }
+        }
+    }
+
+    if(writeFailed)
+    {
+        m_output.clear();
         throw WriteError();
+    }
+    if(readFailed)
+        throw ReadError();
+
+    return received;
 }
+#endif
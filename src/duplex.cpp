@@ -30,13 +30,17 @@
 #include <cmath>
 
 #include "libicom/duplex.hpp"
-#include "bcd.hpp"
+#include "libicom/state.hpp"
+#include "libicom/bcd.hpp"
 
 bool Icom::GetDuplex::subcomplete()
 {
-    if(m_result.size() == 4 && m_result.front() == code)
+    uint64_t offset;
+    if(m_result.size() == 4
+            && m_result.front() == code
+            && getBCD(m_result.begin()+1, m_result.end(), offset))
     {
-        m_offset = (unsigned int)getBCD(m_result.begin()+1, m_result.end());
+        m_offset = (unsigned int)offset;
         m_status=SUCCESS;
     }
     else
@@ -45,51 +49,98 @@ bool Icom::GetDuplex::subcomplete()
     return true;
 }
 
+void Icom::GetDuplex::update(RadioState& state) const
+{
+    state.offset.set(m_offset);
+}
+
+bool Icom::GetDuplex::recall(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(!state.offset.fresh(maxAge))
+        return false;
+
+    m_offset = state.offset.value;
+    m_status = SUCCESS;
+    return true;
+}
+
 Icom::GetDuplex::GetDuplex(const device_t& dev):
-    Command_base(dev)
+    Command_base(dev, true, BACKGROUND)
+{
+    m_command.push_back(code);
+}
+
+Icom::GetDuplexMode::GetDuplexMode(const device_t& dev):
+    Command_base(dev, true, BACKGROUND),
+    m_duplex(SIMPLEX)
 {
     m_command.push_back(code);
 }
 
+bool Icom::GetDuplexMode::subcomplete()
+{
+    if(m_result.size() == 2
+            && m_result.front() == code
+            && m_result[1] >= SIMPLEX
+            && m_result[1] <= DUPLEXPLUS)
+    {
+        m_duplex = (duplex_t)m_result[1];
+        m_status=SUCCESS;
+    }
+    else
+        m_status=PARSEERROR;
+
+    return true;
+}
+
 Icom::SetDuplex::SetDuplex(
         const device_t& dev,
-        int offset):
+        duplex_t duplex):
+    Command_base(dev)
+{
+    m_command.push_back(code);
+    m_command.push_back(duplex);
+}
+
+Icom::SetOffset::SetOffset(
+        const device_t& dev,
+        unsigned int offset):
     Command_base(dev),
-    m_started(false),
     m_offset(offset)
 {
-    m_command.push_back(mode_code);
-    if(offset==0)
-        m_command.push_back(0x10);
-    else if(offset < 0)
-        m_command.push_back(0x11);
-    else
-        m_command.push_back(0x12);
+    m_command.resize(4);
+    m_command.front()=code;
+    putBCD(m_command.begin()+1, m_command.end(), offset);
 }
 
-const uint8_t Icom::GetDuplex::code;
-const uint8_t Icom::SetDuplex::mode_code;
-const uint8_t Icom::SetDuplex::offset_code;
+void Icom::SetOffset::update(RadioState& state) const
+{
+    state.offset.set(m_offset);
+}
 
-bool Icom::SetDuplex::subcomplete()
+Icom::Commands Icom::duplexCommands(const device_t& dev, int offset)
 {
-    if(!m_started)
-    {
-        if(m_offset)
-        {
-            m_command.resize(4);
-            m_command.front()=offset_code;
-            putBCD(m_command.begin()+1, m_command.end(), std::abs(m_offset));
-            m_started = true;
-            return false;
-        }
-        else
-        {
-            m_started=SUCCESS;
-            return true;
-        }
-    }
-    
-    m_started=SUCCESS;
-    return true;
+    Commands commands;
+    commands.push_back(Command(SetDuplex::make(
+                    dev,
+                    offset==0 ? SIMPLEX :
+                    offset<0 ? DUPLEXMINUS : DUPLEXPLUS)));
+    if(offset)
+        commands.push_back(Command(SetOffset::make(dev, std::abs(offset))));
+    return commands;
 }
+
+const Icom::duplexNames_t Icom::duplexNames =
+{
+    "","","","","","","","","","","","","","","","",
+    "simplex",
+    "minus",
+    "plus"
+};
+
+const uint8_t Icom::GetDuplex::code;
+const uint8_t Icom::GetDuplexMode::code;
+const uint8_t Icom::SetDuplex::code;
+const uint8_t Icom::SetOffset::code;
@@ -29,30 +29,47 @@
 #include <limits>
 
 #include "libicom/frequency.hpp"
-#include "bcd.hpp"
+#include "libicom/state.hpp"
+#include "libicom/bcd.hpp"
 
 bool Icom::GetFrequency::subcomplete()
 {
     m_frequency=0;
+    m_status=PARSEERROR;
 
-    if(m_result.size() && m_result.front() == code)
+    uint64_t frequency;
+    if(m_result.size()
+            && m_result.front() == code
+            && getBCD(m_result.begin()+1, m_result.end(), frequency)
+            && frequency
+                <= (uint64_t)(std::numeric_limits<unsigned int>::max()))
     {
-        const uint64_t bigBCD = getBCD(m_result.begin()+1, m_result.end());
-
-        if(bigBCD <= (uint64_t)(std::numeric_limits<unsigned int>::max()))
-            m_frequency = (unsigned int)bigBCD;
+        m_frequency = (unsigned int)frequency;
+        m_status=SUCCESS;
     }
 
-    if(m_frequency)
-        m_status=SUCCESS;
-    else
-        m_status=PARSEERROR;
+    return true;
+}
 
+void Icom::GetFrequency::update(RadioState& state) const
+{
+    state.frequency.set(m_frequency);
+}
+
+bool Icom::GetFrequency::recall(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(!state.frequency.fresh(maxAge))
+        return false;
+
+    m_frequency = state.frequency.value;
+    m_status = SUCCESS;
     return true;
 }
 
 Icom::GetFrequency::GetFrequency(const device_t& dev):
-    Command_base(dev, true)
+    Command_base(dev, true, BACKGROUND)
 {
     m_command.push_back(code);
 }
@@ -60,7 +77,38 @@ Icom::GetFrequency::GetFrequency(const device_t& dev):
 Icom::SetFrequency::SetFrequency(const device_t& dev, unsigned int frequency):
     Command_base(dev, false)
 {
-    m_command.resize(6);
-    m_command.front() = code;
-    putBCD(m_command.begin()+1, m_command.end(), frequency);
+    const Payload data = payload(frequency);
+    m_command.assign(data.cbegin(), data.cend());
 }
+
+Icom::SetFrequency::SetFrequency(const device_t& dev, const Payload& payload):
+    Command_base(dev, false)
+{
+    m_command.assign(payload.cbegin(), payload.cend());
+}
+
+void Icom::SetFrequency::update(RadioState& state) const
+{
+    // Nothing acknowledges this so the value is only assumed. A payload we
+    // can't decode tells us nothing about the device.
+    if(valid(m_command.data()))
+        state.frequency.assume(frequency(m_command.data()));
+    else
+        state.frequency.invalidate();
+}
+
+bool Icom::SetFrequency::suppress(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(!state.frequency.confirmed(maxAge)
+            || !valid(m_command.data())
+            || state.frequency.value != frequency(m_command.data()))
+        return false;
+
+    m_status = SUCCESS;
+    return true;
+}
+
+const uint8_t Icom::SetFrequency::code;
+const uint8_t Icom::GetFrequency::code;
@@ -0,0 +1,242 @@
+/*!
+ * @file       memory.cpp
+ * @brief      Defines the classes for reading and writing memory channels
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "libicom/memory.hpp"
+#include "libicom/bcd.hpp"
+
+namespace
+{
+    const uint8_t code=0x1a;  //!< Command code
+    const uint8_t subcode=0x00;  //!< Memory contents sub-command code
+    const uint8_t blank=0xff;  //!< Contents of a blank channel
+
+    //! Positions of the basics in the channel contents
+    enum: size_t
+    {
+        frequencyOffset=0,
+        frequencySize=5,
+        modeOffset=5,
+        filterOffset=6,
+        basicSize=7
+    };
+
+    //! Append a channel number as four BCD digits, most significant first
+    void putChannel(Icom::Buffer& command, const unsigned int channel)
+    {
+        const uint64_t packed = Icom::packBCD(channel%10000);
+        command.push_back(Icom::bcdByte(packed, 1));
+        command.push_back(Icom::bcdByte(packed, 0));
+    }
+
+    //! The start of any memory command for a channel
+    void putHeader(Icom::Buffer& command, const unsigned int channel)
+    {
+        command.push_back(code);
+        command.push_back(subcode);
+        putChannel(command, channel);
+    }
+}
+
+unsigned int Icom::Memory::frequency() const
+{
+    if(data.size() < basicSize)
+        return 0;
+
+    const uint64_t packed = loadBCD(
+            data.data()+frequencyOffset,
+            frequencySize);
+    return validBCD(packed) ? (unsigned int)unpackBCD(packed) : 0;
+}
+
+Icom::mode_t Icom::Memory::mode() const
+{
+    return data.size() < basicSize ? LSB : (mode_t)data[modeOffset];
+}
+
+Icom::filter_t Icom::Memory::filter() const
+{
+    return data.size() < basicSize ? NONE : (filter_t)data[filterOffset];
+}
+
+bool Icom::Memory::matches(const Memory& channel) const
+{
+    if(blank())
+        return channel.blank();
+
+    return data.size() <= channel.data.size()
+        && std::equal(data.cbegin(), data.cend(), channel.data.cbegin());
+}
+
+Icom::Memory Icom::Memory::make(
+        const unsigned int frequency,
+        const mode_t mode,
+        const filter_t filter)
+{
+    Memory memory;
+    memory.data.resize(basicSize);
+    putBCD(
+            memory.data.begin()+frequencyOffset,
+            memory.data.begin()+frequencyOffset+frequencySize,
+            frequency);
+    memory.data[modeOffset] = mode;
+    memory.data[filterOffset] = filter;
+    return memory;
+}
+
+Icom::GetMemory::GetMemory(const device_t& dev, unsigned int channel):
+    Command_base(dev, true, BACKGROUND),
+    m_channel(channel)
+{
+    putHeader(m_command, channel);
+}
+
+bool Icom::GetMemory::subcomplete()
+{
+    m_status=PARSEERROR;
+    m_memory.data.clear();
+
+    // The reply echoes the code, sub-command and channel number
+    if(m_result.size() <= m_command.size()
+            || !std::equal(
+                m_command.begin(),
+                m_command.end(),
+                m_result.begin()))
+        return true;
+
+    if(m_result.size() != m_command.size()+1 || m_result.back() != blank)
+        m_memory.data.assign(
+                m_result.begin()+m_command.size(),
+                m_result.end());
+    m_status=SUCCESS;
+
+    return true;
+}
+
+Icom::SetMemory::SetMemory(
+        const device_t& dev,
+        unsigned int channel,
+        const Memory& memory):
+    Command_base(dev),
+    m_channel(channel)
+{
+    putHeader(m_command, channel);
+    if(memory.blank())
+        m_command.push_back(blank);
+    else
+        m_command.insert(
+                m_command.end(),
+                memory.data.begin(),
+                memory.data.end());
+}
+
+Icom::ClearMemory::ClearMemory(const device_t& dev, unsigned int channel):
+    Command_base(dev)
+{
+    putHeader(m_command, channel);
+    m_command.push_back(blank);
+}
+
+Icom::Memories Icom::readMemories(
+        const Controller& controller,
+        const device_t& dev,
+        const unsigned int first,
+        const unsigned int count,
+        const size_t window)
+{
+    Memories memories;
+
+    Commands batch;
+    batch.reserve(window);
+    for(unsigned int start=first; start<first+count; start+=window)
+    {
+        batch.clear();
+        for(unsigned int channel=start;
+                channel<start+window && channel<first+count;
+                ++channel)
+            batch.push_back(Command(GetMemory::make(dev, channel)));
+
+        controller.execute(batch);
+
+        for(const auto& command: batch)
+            if(command->status() == SUCCESS)
+            {
+                const GetMemory& read =
+                    static_cast<const GetMemory&>(*command);
+                memories[read.channel()] = read.result();
+            }
+    }
+
+    return memories;
+}
+
+Icom::MemorySync Icom::syncMemories(
+        const Controller& controller,
+        const device_t& dev,
+        const Memories& desired,
+        const size_t window)
+{
+    MemorySync sync;
+
+    Commands batch;
+    batch.reserve(2*window);
+    Commands writes;
+    writes.reserve(window);
+    Memories::const_iterator next = desired.begin();
+    while(next != desired.end() || !writes.empty())
+    {
+        // Writes for the last window go out with the reads for this one
+        batch.swap(writes);
+        writes.clear();
+        const size_t sets = batch.size();
+        for(size_t i=0; i<window && next!=desired.end(); ++i, ++next)
+            batch.push_back(Command(GetMemory::make(dev, next->first)));
+
+        controller.execute(batch);
+
+        for(size_t i=0; i<sets; ++i)
+        {
+            const SetMemory& write = static_cast<const SetMemory&>(*batch[i]);
+            if(write.status() == SUCCESS)
+                sync.written.push_back(write.channel());
+            else
+                sync.failed.push_back(write.channel());
+        }
+
+        for(size_t i=sets; i<batch.size(); ++i)
+        {
+            const GetMemory& read = static_cast<const GetMemory&>(*batch[i]);
+            const Memory& memory = desired.at(read.channel());
+            if(read.status() != SUCCESS || !memory.matches(read.result()))
+                writes.push_back(
+                        Command(SetMemory::make(dev, read.channel(), memory)));
+        }
+    }
+
+    return sync;
+}
@@ -0,0 +1,196 @@
+/*!
+ * @file       meter.cpp
+ * @brief      Defines the Icom::GetMeter and Icom::Sampler classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "libicom/meter.hpp"
+#include "libicom/bcd.hpp"
+
+Icom::GetMeter::GetMeter(const device_t& dev, meter_t meter):
+    Command_base(dev, true, BACKGROUND),
+    m_meter(meter),
+    m_value(0)
+{
+    m_command.push_back(code);
+    m_command.push_back(meter);
+}
+
+bool Icom::GetMeter::subcomplete()
+{
+    m_status=PARSEERROR;
+
+    if(m_result.size() < 3 || m_result[0] != code || m_result[1] != m_meter)
+        return true;
+
+    switch(m_result.size())
+    {
+        case 3:
+            // Status
+            m_value = m_result[2];
+            m_status = SUCCESS;
+            break;
+        case 4:
+        {
+            // Level with the most significant digits first
+            const uint64_t packed = (uint64_t)m_result[3]
+                | (uint64_t)m_result[2]<<8;
+            if(validBCD(packed))
+            {
+                m_value = unpackBCD(packed);
+                m_status = SUCCESS;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+const Icom::meterNames_t Icom::meterNames = {
+        "",
+        "squelch",
+        "s-meter",
+        "","",
+        "various-squelch",
+        "","","","","","","","","","","",
+        "power",
+        "swr",
+        "alc",
+        "comp",
+        "voltage",
+        "current"};
+
+const uint8_t Icom::GetMeter::code;
+const unsigned int Icom::Sampler::backoff;
+
+Icom::SampleRing::SampleRing(const size_t capacity):
+    m_samples([capacity]()
+    {
+        size_t size = 1;
+        while(size < capacity)
+            size <<= 1;
+        return size;
+    }()),
+    m_mask(m_samples.size()-1),
+    m_head(0),
+    m_tail(0)
+{}
+
+bool Icom::SampleRing::push(const Sample& sample)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if(tail - m_head.load(std::memory_order_acquire) == m_samples.size())
+        return false;
+
+    m_samples[tail & m_mask] = sample;
+    m_tail.store(tail+1, std::memory_order_release);
+    return true;
+}
+
+size_t Icom::SampleRing::pop(Sample* samples, const size_t size)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    const size_t available = std::min(
+            size,
+            m_tail.load(std::memory_order_acquire) - head);
+
+    for(size_t i=0; i<available; ++i)
+        samples[i] = m_samples[(head+i) & m_mask];
+
+    m_head.store(head+available, std::memory_order_release);
+    return available;
+}
+
+Icom::Sampler::Sampler(
+        const Controller& controller,
+        const std::vector<Channel>& channels,
+        const size_t capacity,
+        const Clock::duration interval):
+    m_controller(controller),
+    m_channels(channels),
+    m_interval(interval),
+    m_ring(capacity),
+    m_dropped(0),
+    m_errors(0),
+    m_running(true),
+    m_thread(&Sampler::run, this)
+{}
+
+Icom::Sampler::~Sampler()
+{
+    m_running = false;
+    m_thread.join();
+}
+
+void Icom::Sampler::run()
+{
+    Commands batch;
+    batch.reserve(m_channels.size());
+    for(const auto& channel: m_channels)
+        batch.push_back(Command(GetMeter::make(channel.device, channel.meter)));
+
+    while(m_running)
+    {
+        const Clock::time_point start = Clock::now();
+
+        for(auto& command: batch)
+            command->reset();
+
+        try
+        {
+            m_controller.execute(batch);
+        }
+        catch(...)
+        {
+            // A corrupted frame only costs us this batch. Don't hammer a bus
+            // that is failing.
+            ++m_errors;
+            std::this_thread::sleep_until(start + std::max<Clock::duration>(
+                        m_interval,
+                        std::chrono::milliseconds(backoff)));
+            continue;
+        }
+
+        for(const auto& command: batch)
+        {
+            const GetMeter& meter = static_cast<const GetMeter&>(*command);
+            if(meter.status() != SUCCESS)
+                continue;
+
+            const Sample sample = {
+                meter.sent(),
+                meter.device.address,
+                meter.meter(),
+                (uint16_t)meter.result()};
+            if(!m_ring.push(sample))
+                ++m_dropped;
+        }
+
+        if(m_interval != Clock::duration::zero())
+            std::this_thread::sleep_until(start+m_interval);
+    }
+}
@@ -29,6 +29,7 @@
 #include <limits>
 
 #include "libicom/mode.hpp"
+#include "libicom/state.hpp"
 
 bool Icom::GetMode::subcomplete()
 {
@@ -61,8 +62,27 @@ bool Icom::GetMode::subcomplete()
     return true;
 }
 
+void Icom::GetMode::update(RadioState& state) const
+{
+    state.mode.set(m_mode);
+    state.filter.set(m_filter);
+}
+
+bool Icom::GetMode::recall(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(!state.mode.fresh(maxAge) || !state.filter.fresh(maxAge))
+        return false;
+
+    m_mode = state.mode.value;
+    m_filter = state.filter.value;
+    m_status = SUCCESS;
+    return true;
+}
+
 Icom::GetMode::GetMode(const device_t& dev):
-    Command_base(dev)
+    Command_base(dev, true, BACKGROUND)
 {
     m_command.push_back(code);
 }
@@ -79,6 +99,32 @@ Icom::SetMode::SetMode(
         m_command.push_back((uint8_t)filter);
 }
 
+void Icom::SetMode::update(RadioState& state) const
+{
+    state.mode.set((mode_t)m_command[1]);
+
+    // Without a filter the device picks its default for the mode
+    if(m_command.size() == 3)
+        state.filter.set((filter_t)m_command[2]);
+    else
+        state.filter.invalidate();
+}
+
+bool Icom::SetMode::suppress(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(m_command.size() != 3
+            || !state.mode.confirmed(maxAge)
+            || !state.filter.confirmed(maxAge)
+            || state.mode.value != (mode_t)m_command[1]
+            || state.filter.value != (filter_t)m_command[2])
+        return false;
+
+    m_status = SUCCESS;
+    return true;
+}
+
 const Icom::modeNames_t Icom::modeNames = {
         "LSB",
         "USB",
@@ -0,0 +1,176 @@
+/*!
+ * @file       plan.cpp
+ * @brief      Defines the Icom::FrequencyPlan class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "libicom/plan.hpp"
+#include "libicom/command.hpp"
+
+namespace
+{
+    //! Start of every plan file
+    struct FileHeader
+    {
+        char magic[8];  //!< Identifies the format
+        uint8_t model;  //!< Model of the device
+        uint8_t address;  //!< Address of the device
+        uint8_t controller;  //!< Address of the controller
+        uint8_t reserved[5];  //!< Zero
+        uint64_t size;  //!< Number of channels
+    };
+
+    const char magic[8] = {'I', 'C', 'O', 'M', 'P', 'L', 'N', '1'};
+}
+
+const size_t Icom::FrequencyPlan::frameSize;
+
+void Icom::FrequencyPlan::write(
+        const std::string& path,
+        const device_t& device,
+        const uint8_t controller,
+        const std::vector<unsigned int>& frequencies)
+{
+    std::vector<uint8_t> data(
+            sizeof(FileHeader) + frequencies.size()*frameSize);
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.model = device.model;
+    header.address = device.address;
+    header.controller = controller;
+    header.size = frequencies.size();
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    uint8_t* frame = data.data() + sizeof(FileHeader);
+    for(const auto frequency: frequencies)
+    {
+        const SetFrequency::Payload payload = SetFrequency::payload(frequency);
+        frame[0] = Command_base::header;
+        frame[1] = Command_base::header;
+        frame[2] = device.address;
+        frame[3] = controller;
+        std::copy(payload.cbegin(), payload.cend(), frame+4);
+        frame[frameSize-1] = Command_base::footer;
+        frame += frameSize;
+    }
+
+    const int fd = open(
+            path.c_str(),
+            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            0644);
+    if(fd == -1)
+        throw CantOpenPlan();
+
+    size_t position=0;
+    while(position < data.size())
+    {
+        const ssize_t n = ::write(
+                fd,
+                data.data()+position,
+                data.size()-position);
+        if(n < 0)
+        {
+            close(fd);
+            throw CantOpenPlan();
+        }
+        position += n;
+    }
+    close(fd);
+}
+
+Icom::FrequencyPlan::FrequencyPlan(const std::string& path):
+    m_size(0),
+    m_map(nullptr),
+    m_length(0),
+    m_frames(nullptr)
+{
+    m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(m_fd == -1)
+        throw CantOpenPlan();
+
+    struct stat status;
+    if(fstat(m_fd, &status) == -1
+            || (size_t)status.st_size < sizeof(FileHeader))
+    {
+        close(m_fd);
+        throw InvalidPlan();
+    }
+
+    m_length = status.st_size;
+    const void* const map = mmap(
+            nullptr,
+            m_length,
+            PROT_READ,
+            MAP_SHARED,
+            m_fd,
+            0);
+    if(map == MAP_FAILED)
+    {
+        close(m_fd);
+        throw CantOpenPlan();
+    }
+    m_map = static_cast<const uint8_t*>(map);
+
+    FileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if(std::memcmp(header.magic, magic, sizeof(magic))
+            || header.size != (m_length-sizeof(FileHeader))/frameSize
+            || (m_length-sizeof(FileHeader))%frameSize)
+    {
+        munmap(const_cast<uint8_t*>(m_map), m_length);
+        close(m_fd);
+        throw InvalidPlan();
+    }
+
+    m_device.model = (model_t)header.model;
+    m_device.address = header.address;
+    m_controller = header.controller;
+    m_size = header.size;
+    m_frames = m_map + sizeof(FileHeader);
+    madvise(const_cast<uint8_t*>(m_map), m_length, MADV_SEQUENTIAL);
+}
+
+Icom::FrequencyPlan::~FrequencyPlan()
+{
+    munmap(const_cast<uint8_t*>(m_map), m_length);
+    close(m_fd);
+}
+
+Icom::SetFrequency::Payload Icom::FrequencyPlan::payload(
+        const size_t channel) const
+{
+    SetFrequency::Payload payload;
+    std::memcpy(payload.data(), frame(channel)+4, payload.size());
+    return payload;
+}
@@ -0,0 +1,289 @@
+/*!
+ * @file       poller.cpp
+ * @brief      Defines the Icom::Poller class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/poller.hpp"
+
+#include <algorithm>
+
+const unsigned int Icom::Poller::levels;
+const unsigned int Icom::Poller::bits;
+const unsigned int Icom::Poller::slots;
+const unsigned int Icom::Poller::pollsPerChange;
+const unsigned int Icom::Poller::gapSmoothing;
+
+Icom::Poller::Poller(const Clock::duration tick):
+    m_tick(tick),
+    m_epoch(Clock::now()),
+    m_now(0),
+    m_next(0),
+    m_running(true),
+    m_thread(&Poller::run, this)
+{}
+
+Icom::Poller::~Poller()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_stopped.notify_all();
+    m_thread.join();
+}
+
+Icom::Poller::Handle Icom::Poller::add(
+        const Controller& controller,
+        const device_t& device,
+        const Factory& factory,
+        const Clock::duration interval,
+        const Callback& callback)
+{
+    return add(controller, device, factory, interval, interval, callback);
+}
+
+Icom::Poller::Handle Icom::Poller::add(
+        const Controller& controller,
+        const device_t& device,
+        const Factory& factory,
+        const Clock::duration minInterval,
+        const Clock::duration maxInterval,
+        const Callback& callback)
+{
+    const unsigned long minimum = std::max<unsigned long>(
+            1,
+            (minInterval + m_tick - Clock::duration(1)) / m_tick);
+    const unsigned long maximum = std::max<unsigned long>(
+            minimum,
+            (maxInterval + m_tick - Clock::duration(1)) / m_tick);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const unsigned long now = ticks(Clock::now());
+    const std::shared_ptr<Registration> registration(new Registration{
+            controller,
+            device,
+            factory,
+            callback,
+            minimum,
+            maximum,
+            minimum,
+            Buffer(),
+            now,
+            0,
+            now + minimum,
+            false,
+            true,
+            0,
+            Slot::iterator()});
+    arm(registration);
+
+    const Handle handle = m_next++;
+    m_registrations.insert(std::make_pair(handle, registration));
+    return handle;
+}
+
+void Icom::Poller::remove(const Handle handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto registration = m_registrations.find(handle);
+    if(registration == m_registrations.end())
+        return;
+
+    disarm(*registration->second);
+    registration->second->active = false;
+    m_registrations.erase(registration);
+}
+
+Icom::Clock::duration Icom::Poller::interval(const Handle handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto registration = m_registrations.find(handle);
+    if(registration == m_registrations.end())
+        return Clock::duration::zero();
+    return registration->second->interval * m_tick;
+}
+
+void Icom::Poller::arm(const std::shared_ptr<Registration>& registration)
+{
+    if(registration->expiry <= m_now)
+        registration->expiry = m_now+1;
+
+    // Find the lowest level whose span covers the wait
+    const unsigned long delta = registration->expiry - m_now;
+    unsigned int level = 0;
+    while(level+1 < levels && delta >= 1ul<<(bits*(level+1)))
+        ++level;
+
+    Slot& slot =
+        m_wheel[level][(registration->expiry >> (bits*level)) & (slots-1)];
+    registration->level = level;
+    registration->position = slot.insert(slot.end(), registration);
+    registration->armed = true;
+}
+
+void Icom::Poller::disarm(Registration& registration)
+{
+    if(!registration.armed)
+        return;
+
+    const unsigned int level = registration.level;
+    m_wheel[level][(registration.expiry >> (bits*level)) & (slots-1)]
+        .erase(registration.position);
+    registration.armed = false;
+}
+
+void Icom::Poller::advance(std::vector<std::shared_ptr<Registration>>& due)
+{
+    ++m_now;
+
+    // Each time a level wraps, the next slot of the level above is spread
+    // out over the levels below
+    for(unsigned int level=1; level<levels; ++level)
+    {
+        if(m_now & ((1ul<<(bits*level))-1))
+            break;
+
+        Slot cascade;
+        cascade.swap(m_wheel[level][(m_now >> (bits*level)) & (slots-1)]);
+        for(auto& registration: cascade)
+        {
+            registration->armed = false;
+
+            // Anything expiring on this very tick is due now. Rearming it
+            // would push it a tick late.
+            if(registration->expiry == m_now)
+                due.push_back(registration);
+            else
+                arm(registration);
+        }
+    }
+
+    Slot& slot = m_wheel[0][m_now & (slots-1)];
+    for(auto& registration: slot)
+    {
+        registration->armed = false;
+        due.push_back(registration);
+    }
+    slot.clear();
+}
+
+void Icom::Poller::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::vector<std::shared_ptr<Registration>> due;
+    std::vector<Command> commands;
+    std::map<const Controller*, Commands> batches;
+
+    while(m_running)
+    {
+        m_stopped.wait_until(lock, m_epoch + (m_now+1)*m_tick);
+        const unsigned long now = ticks(Clock::now());
+        while(m_running && m_now < now)
+            advance(due);
+        if(due.empty())
+            continue;
+        lock.unlock();
+
+        // Make the polls and batch them by bus
+        commands.clear();
+        for(auto& registration: due)
+        {
+            commands.push_back(registration->factory(registration->device));
+            batches[&registration->controller].push_back(commands.back());
+        }
+
+        for(auto& batch: batches)
+        {
+            try
+            {
+                batch.first->execute(batch.second);
+            }
+            catch(...)
+            {
+                // Failed polls are delivered with an INCOMPLETE status
+            }
+            batch.second.clear();
+        }
+
+        for(size_t i=0; i<due.size(); ++i)
+            due[i]->callback(commands[i]);
+
+        lock.lock();
+
+        // Keep to the schedule unless we have fallen behind it
+        for(size_t i=0; i<due.size(); ++i)
+            if(due[i]->active)
+            {
+                adapt(*due[i], commands[i]);
+                due[i]->expiry += due[i]->interval;
+                arm(due[i]);
+            }
+        due.clear();
+    }
+}
+
+void Icom::Poller::adapt(Registration& registration, const Command& command)
+{
+    if(registration.minimum == registration.maximum
+            || command->status() != SUCCESS
+            || command->resultData().empty())
+        return;
+
+    if(command->resultData() != registration.last)
+    {
+        // The first reply isn't a change, only something to compare to
+        if(!registration.last.empty())
+        {
+            const double gap = m_now - registration.changed;
+            registration.gap = registration.gap
+                ? registration.gap + (gap-registration.gap)/gapSmoothing
+                : gap;
+            registration.changed = m_now;
+            registration.interval = registration.minimum;
+        }
+        registration.last = command->resultData();
+        return;
+    }
+
+    // Back off towards a few polls per typical gap between changes. The
+    // time since the last change counts as a gap once it is longer.
+    const double gap = std::max<double>(
+            registration.gap,
+            m_now - registration.changed);
+    const unsigned long target = std::min<unsigned long>(
+            registration.maximum,
+            std::max<unsigned long>(
+                registration.minimum,
+                gap/pollsPerChange));
+    if(registration.interval < target)
+        registration.interval = std::min(2*registration.interval, target);
+    else
+        registration.interval = target;
+}
+
+unsigned long Icom::Poller::ticks(const Clock::time_point time) const
+{
+    return (time - m_epoch) / m_tick;
+}
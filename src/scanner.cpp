@@ -0,0 +1,270 @@
+/*!
+ * @file       scanner.cpp
+ * @brief      Defines the Icom::Scanner class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/scanner.hpp"
+#include "libicom/frequency.hpp"
+#include "libicom/meter.hpp"
+#include "libicom/squelch.hpp"
+
+Icom::Scanner::Scanner(
+        const Controller& controller,
+        const device_t& device,
+        const std::vector<unsigned int>& channels,
+        const Callback& callback,
+        const Clock::duration settle,
+        const Clock::duration hang):
+    m_controller(controller),
+    m_device(device),
+    m_channels(channels),
+    m_callback(callback),
+    m_settle(settle),
+    m_hang(hang),
+    m_stepped(0),
+    m_scanning(0),
+    m_errors(0),
+    m_running(!channels.empty()),
+    m_thread(&Scanner::run, this)
+{}
+
+Icom::Scanner::Scanner(
+        const Controller& controller,
+        const std::shared_ptr<const FrequencyPlan>& plan,
+        const Callback& callback,
+        const Clock::duration settle,
+        const Clock::duration hang):
+    m_controller(controller),
+    m_device(plan->device()),
+    m_plan(plan),
+    m_callback(callback),
+    m_settle(settle),
+    m_hang(hang),
+    m_stepped(0),
+    m_scanning(0),
+    m_errors(0),
+    m_running(plan->size() != 0),
+    m_thread(&Scanner::run, this)
+{}
+
+Icom::Scanner::~Scanner()
+{
+    m_running = false;
+    m_thread.join();
+}
+
+std::vector<unsigned int> Icom::Scanner::range(
+        const unsigned int start,
+        const unsigned int stop,
+        const unsigned int step)
+{
+    std::vector<unsigned int> channels;
+    if(step == 0 || stop < start)
+        return channels;
+
+    channels.reserve((stop-start)/step + 1);
+    for(unsigned long frequency=start; frequency<=stop; frequency+=step)
+        channels.push_back(frequency);
+    return channels;
+}
+
+double Icom::Scanner::rate() const
+{
+    const Clock::duration scanning(m_scanning.load());
+    if(scanning == Clock::duration::zero())
+        return 0;
+    return m_stepped / std::chrono::duration<double>(scanning).count();
+}
+
+void Icom::Scanner::run()
+{
+    size_t channel = 0;
+    bool tuned = false;
+    Clock::time_point settled;
+
+    Command squelch(GetMeter::make(m_device, SQUELCHSTATUS));
+    Commands step;
+    step.reserve(2);
+    while(m_running)
+    {
+        if(!tuned)
+        {
+            try
+            {
+                tune(channel);
+            }
+            catch(...)
+            {
+                failed();
+                channel = (channel+1) % channels();
+                continue;
+            }
+            tuned = true;
+            settled = Clock::now() + m_settle;
+        }
+
+        std::this_thread::sleep_until(settled);
+        const Clock::time_point start = Clock::now();
+        const size_t next = (channel+1) % channels();
+
+        // The device processes frames in order so the squelch is read
+        // before the next channel is tuned
+        squelch->reset();
+        try
+        {
+            if(m_plan)
+            {
+                m_controller.execute(squelch);
+                m_controller.hop(m_plan->frame(next));
+            }
+            else
+            {
+                step.clear();
+                step.push_back(squelch);
+                step.push_back(Command(
+                            SetFrequency::make(m_device, m_channels[next])));
+                m_controller.execute(step);
+            }
+        }
+        catch(...)
+        {
+            // We can't be sure where the device is tuned so start again on
+            // the next channel
+            failed();
+            tuned = false;
+            channel = next;
+            continue;
+        }
+
+        const Clock::time_point now = Clock::now();
+        settled = now + m_settle;
+        m_scanning += (now - start + m_settle).count();
+        ++m_stepped;
+
+        const GetMeter& meter = static_cast<const GetMeter&>(*squelch);
+        if(meter.status() == SUCCESS && meter.result() == OPEN)
+        {
+            hold(channel);
+            tuned = false;
+        }
+
+        channel = next;
+    }
+}
+
+void Icom::Scanner::tune(const size_t channel) const
+{
+    if(m_plan)
+        m_controller.hop(m_plan->frame(channel));
+    else
+    {
+        Command command(SetFrequency::make(m_device, m_channels[channel]));
+        m_controller.execute(command);
+    }
+}
+
+void Icom::Scanner::hold(const size_t channel)
+{
+    try
+    {
+        tune(channel);
+    }
+    catch(...)
+    {
+        failed();
+        return;
+    }
+
+    try
+    {
+        m_callback(frequency(channel));
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failure = std::current_exception();
+        m_running = false;
+        return;
+    }
+
+    try
+    {
+        // Wait for the squelch to close and then stay closed for the hang
+        // time. The waits are chopped up so that we notice being stopped.
+        const std::chrono::milliseconds slice(250);
+        Clock::time_point resume = Clock::time_point::max();
+        while(m_running)
+        {
+            if(resume == Clock::time_point::max())
+            {
+                Command wait(SquelchHold::make(m_device, CLOSED, slice));
+                m_controller.execute(wait);
+                if(wait->status() == SUCCESS)
+                    resume = Clock::now() + m_hang;
+                else if(wait->status() != TIMEOUT)
+                    return;
+            }
+            else
+            {
+                const Clock::time_point now = Clock::now();
+                if(now >= resume)
+                    return;
+
+                Command wait(SquelchHold::make(
+                            m_device,
+                            OPEN,
+                            std::min(
+                                slice,
+                                std::chrono::duration_cast<
+                                    std::chrono::milliseconds>(resume-now)
+                                + std::chrono::milliseconds(1))));
+                m_controller.execute(wait);
+                if(wait->status() == SUCCESS)
+                    resume = Clock::time_point::max();
+                else if(wait->status() != TIMEOUT)
+                    return;
+            }
+        }
+    }
+    catch(...)
+    {
+        failed();
+    }
+}
+
+const unsigned int Icom::Scanner::backoff;
+
+void Icom::Scanner::failed()
+{
+    ++m_errors;
+    std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+}
+
+void Icom::Scanner::rethrow() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_failure)
+        std::rethrow_exception(m_failure);
+}
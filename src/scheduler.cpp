@@ -0,0 +1,131 @@
+/*!
+ * @file       scheduler.cpp
+ * @brief      Defines the Icom::Scheduler class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/scheduler.hpp"
+
+Icom::Scheduler::Scheduler(const Clock::duration promotion):
+    m_busy(false),
+    m_promotion(promotion)
+{}
+
+Icom::Scheduler::Ticket::Ticket(
+        Scheduler& scheduler,
+        const priority_t priority,
+        const Clock::time_point deadline):
+    m_scheduler(scheduler),
+    m_held(true)
+{
+    m_scheduler.acquire(priority, deadline);
+}
+
+Icom::Scheduler::Ticket::Ticket(Scheduler& scheduler, std::try_to_lock_t):
+    m_scheduler(scheduler),
+    m_held(m_scheduler.tryAcquire())
+{}
+
+Icom::Scheduler::Ticket::~Ticket()
+{
+    if(m_held)
+        m_scheduler.release();
+}
+
+bool Icom::Scheduler::contended() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_waiters.empty();
+}
+
+void Icom::Scheduler::promoteAfter(const Clock::duration promotion)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_promotion = promotion;
+}
+
+void Icom::Scheduler::acquire(
+        const priority_t priority,
+        const Clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(!m_busy)
+    {
+        m_busy = true;
+        return;
+    }
+
+    Waiter waiter = {priority, deadline, Clock::now(), false};
+    m_waiters.push_back(&waiter);
+    m_granted.wait(lock, [&waiter]() { return waiter.granted; });
+}
+
+bool Icom::Scheduler::tryAcquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_busy)
+        return false;
+    m_busy = true;
+    return true;
+}
+
+void Icom::Scheduler::release()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(m_waiters.empty())
+    {
+        m_busy = false;
+        return;
+    }
+
+    // Find the waiter with the earliest deadline or failing that, the best
+    // promoted priority. Ties go to whoever arrived first.
+    const Clock::time_point now = Clock::now();
+    std::list<Waiter*>::iterator best = m_waiters.end();
+    Clock::time_point bestDeadline = Clock::time_point::max();
+    long bestPriority = 0;
+    for(auto it=m_waiters.begin(); it!=m_waiters.end(); ++it)
+    {
+        long priority = (*it)->priority;
+        if(m_promotion != Clock::duration::zero())
+            priority -= (long)((now-(*it)->since) / m_promotion);
+
+        if(best == m_waiters.end()
+                || (*it)->deadline < bestDeadline
+                || ((*it)->deadline == bestDeadline
+                    && priority < bestPriority))
+        {
+            best = it;
+            bestDeadline = (*it)->deadline;
+            bestPriority = priority;
+        }
+    }
+
+    (*best)->granted = true;
+    m_waiters.erase(best);
+    lock.unlock();
+    m_granted.notify_all();
+}
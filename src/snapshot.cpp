@@ -0,0 +1,91 @@
+/*!
+ * @file       snapshot.cpp
+ * @brief      Defines functions for saving and restoring the state of a device
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/snapshot.hpp"
+#include "libicom/frequency.hpp"
+
+Icom::Snapshot Icom::snapshot(
+        const Controller& controller,
+        const device_t& dev)
+{
+    Commands reads;
+    reads.reserve(4);
+    reads.push_back(Command(GetFrequency::make(dev)));
+    reads.push_back(Command(GetMode::make(dev)));
+    reads.push_back(Command(GetDuplexMode::make(dev)));
+    reads.push_back(Command(GetDuplex::make(dev)));
+
+    // Reads default to the background but somebody is waiting on these
+    for(auto& read: reads)
+        read->setPriority(INTERACTIVE);
+
+    controller.execute(reads);
+
+    for(const auto& read: reads)
+        if(read->status() != SUCCESS)
+            throw SnapshotFailed();
+
+    const GetMode& mode = static_cast<const GetMode&>(*reads[1]);
+    const RadioState state = controller.state(dev);
+
+    Snapshot snapshot;
+    snapshot.frequency =
+        static_cast<const GetFrequency&>(*reads[0]).result();
+    snapshot.offset = static_cast<const GetDuplex&>(*reads[3]).offset();
+    snapshot.mode = mode.mode();
+    snapshot.filter = mode.filter();
+    snapshot.duplex = static_cast<const GetDuplexMode&>(*reads[2]).duplex();
+    snapshot.vfo = state.vfo.value;
+    snapshot.vfoKnown = state.vfo.time != Clock::time_point();
+    return snapshot;
+}
+
+bool Icom::restore(
+        const Controller& controller,
+        const device_t& dev,
+        const Snapshot& snapshot)
+{
+    Commands sets;
+    sets.reserve(7);
+    if(snapshot.vfoKnown)
+        sets.push_back(Command(VFO::make(dev, snapshot.vfo)));
+    sets.push_back(Command(SetFrequency::make(dev, snapshot.frequency)));
+    sets.push_back(Command(SetMode::make(
+                    dev,
+                    snapshot.mode,
+                    snapshot.filter)));
+    sets.push_back(Command(SetDuplex::make(dev, snapshot.duplex)));
+    sets.push_back(Command(SetOffset::make(dev, snapshot.offset)));
+
+    // Setting the frequency isn't acknowledged so read it back
+    const Command check(GetFrequency::make(dev));
+    sets.push_back(check);
+
+    return controller.transact(sets)
+        && static_cast<const GetFrequency&>(*check).result()
+            == snapshot.frequency;
+}
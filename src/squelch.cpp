@@ -26,35 +26,62 @@
  * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "libicom/squelch.hpp"
 
 bool Icom::SquelchHold::subcomplete()
 {
-    if(m_result.size() == 3 &&
-            m_result[0] == code &&
-            m_result[1] == subCode)
+    if(m_result.size() != 3 ||
+            m_result[0] != code ||
+            m_result[1] != subCode)
     {
-        if(m_squelchState == (squelchState_t)m_result[2])
-        {
-            m_status=SUCCESS;
-            return true;
-        }
+        m_status=PARSEERROR;
+        return true;
     }
-    else
+
+    if(m_squelchState == (squelchState_t)m_result[2])
     {
-        m_status=PARSEERROR;
+        m_status=SUCCESS;
         return true;
     }
 
+    const Clock::time_point now = Clock::now();
+    if(m_deadline != Clock::time_point() && now >= m_deadline)
+    {
+        m_status=TIMEOUT;
+        return true;
+    }
+
+    m_due = now + m_interval;
+    if(m_deadline != Clock::time_point())
+        m_due = std::min(m_due, m_deadline);
+    m_interval = std::min(2*m_interval, m_maxInterval);
+
     return false;
 }
 
+void Icom::SquelchHold::transceive(const Buffer& /*data*/)
+{
+    m_interval = m_minInterval;
+    m_due = Clock::time_point();
+}
+
 const uint8_t Icom::SquelchHold::code;
 const uint8_t Icom::SquelchHold::subCode;
 
-Icom::SquelchHold::SquelchHold(const device_t& dev, squelchState_t state):
+Icom::SquelchHold::SquelchHold(
+        const device_t& dev,
+        squelchState_t state,
+        std::chrono::milliseconds timeout,
+        std::chrono::milliseconds minInterval,
+        std::chrono::milliseconds maxInterval):
     Command_base(dev),
-    m_squelchState(state)
+    m_squelchState(state),
+    m_deadline(timeout.count() ? Clock::now()+timeout : Clock::time_point()),
+    m_minInterval(minInterval),
+    m_maxInterval(std::max(minInterval, maxInterval)),
+    m_interval(minInterval)
 {
     m_command.resize(3);
     m_command[0] = code;
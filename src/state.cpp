@@ -0,0 +1,83 @@
+/*!
+ * @file       state.cpp
+ * @brief      Defines the structures for caching the state of an %Icom
+ *             device.
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <limits>
+
+#include "libicom/state.hpp"
+#include "libicom/bcd.hpp"
+
+void Icom::RadioState::invalidate()
+{
+    frequency.invalidate();
+    mode.invalidate();
+    filter.invalidate();
+    offset.invalidate();
+    vfo.invalidate();
+}
+
+void Icom::RadioState::transceive(const Buffer& data)
+{
+    if(data.empty())
+        return;
+
+    switch(data.front())
+    {
+        case frequencyCode:
+        {
+            uint64_t value;
+            if(getBCD(data.begin()+1, data.end(), value)
+                    && value <= std::numeric_limits<unsigned int>::max())
+                frequency.set((unsigned int)value);
+            else
+                frequency.invalidate();
+            return;
+        }
+
+        case modeCode:
+            if(data.size() == 2 || data.size() == 3)
+            {
+                mode.set((mode_t)data[1]);
+                if(data.size() == 3)
+                    filter.set((filter_t)data[2]);
+                else
+                    filter.invalidate();
+            }
+            else
+            {
+                mode.invalidate();
+                filter.invalidate();
+            }
+            return;
+
+        default:
+            invalidate();
+    }
+}
+
+const uint8_t Icom::RadioState::frequencyCode;
+const uint8_t Icom::RadioState::modeCode;
@@ -0,0 +1,438 @@
+/*!
+ * @file       telemetry.cpp
+ * @brief      Defines the Icom::TelemetryWriter and Icom::TelemetryReader
+ *             classes
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "libicom/telemetry.hpp"
+
+namespace
+{
+    //! Start of every telemetry file
+    struct FileHeader
+    {
+        char magic[8];  //!< Identifies the format
+        uint32_t fields;  //!< Fields per row
+        uint32_t reserved;  //!< Zero
+        uint64_t used;  //!< Bytes of the file holding complete blocks
+    };
+
+    //! Start of every block
+    struct BlockHeader
+    {
+        int64_t first;  //!< Timestamp of the first row
+        int64_t last;  //!< Timestamp of the last row
+        uint32_t rows;  //!< Number of rows
+        uint32_t size;  //!< Bytes of encoded columns that follow
+    };
+
+    const char magic[8] = {'I', 'C', 'O', 'M', 'T', 'L', 'M', '1'};
+
+    //! Least size a file is grown by
+    const size_t growth = 1<<20;
+
+    //! Most bytes one encoded value can take
+    const size_t maxVarint = 10;
+
+    uint64_t zigzag(const int64_t value)
+    {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    int64_t unzigzag(const uint64_t value)
+    {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    uint8_t* putVarint(uint8_t* data, uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            *data++ = (uint8_t)value | 0x80;
+            value >>= 7;
+        }
+        *data++ = (uint8_t)value;
+        return data;
+    }
+
+    const uint8_t* getVarint(
+            const uint8_t* data,
+            const uint8_t* const end,
+            uint64_t& value)
+    {
+        value = 0;
+        for(unsigned int shift=0; data != end && shift < 64; shift += 7)
+        {
+            const uint8_t byte = *data++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if(!(byte & 0x80))
+                return data;
+        }
+        return nullptr;
+    }
+}
+
+Icom::TelemetryWriter::TelemetryWriter(
+        const std::string& path,
+        const unsigned int fields,
+        const unsigned int blockRows):
+    m_fields(fields),
+    m_blockRows(blockRows),
+    m_map(nullptr),
+    m_capacity(0),
+    m_last(std::numeric_limits<int64_t>::min()),
+    m_columns(fields+1)
+{
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(m_fd == -1)
+        throw CantOpenStore();
+
+    struct stat status;
+    if(fstat(m_fd, &status) == -1)
+    {
+        close(m_fd);
+        throw CantOpenStore();
+    }
+
+    try
+    {
+        if(status.st_size == 0)
+        {
+            reserve(sizeof(FileHeader));
+            FileHeader& header = *reinterpret_cast<FileHeader*>(m_map);
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.fields = fields;
+            header.reserved = 0;
+            header.used = sizeof(FileHeader);
+        }
+        else
+        {
+            m_capacity = status.st_size;
+            m_map = static_cast<uint8_t*>(mmap(
+                    nullptr,
+                    m_capacity,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED,
+                    m_fd,
+                    0));
+            if(m_map == MAP_FAILED)
+            {
+                m_map = nullptr;
+                throw CantOpenStore();
+            }
+
+            const FileHeader& header =
+                *reinterpret_cast<const FileHeader*>(m_map);
+            if(m_capacity < sizeof(FileHeader)
+                    || std::memcmp(header.magic, magic, sizeof(magic))
+                    || header.fields != fields
+                    || header.used < sizeof(FileHeader)
+                    || header.used > m_capacity)
+                throw InvalidStore();
+
+            // New rows mustn't predate the last block
+            size_t offset = sizeof(FileHeader);
+            while(offset < header.used)
+            {
+                BlockHeader block;
+                if(header.used - offset < sizeof(BlockHeader))
+                    throw InvalidStore();
+                std::memcpy(&block, m_map+offset, sizeof(block));
+                if(block.size > header.used - offset - sizeof(BlockHeader))
+                    throw InvalidStore();
+                m_last = block.last;
+                offset += sizeof(BlockHeader) + block.size;
+            }
+        }
+    }
+    catch(...)
+    {
+        if(m_map)
+            munmap(m_map, m_capacity);
+        close(m_fd);
+        throw;
+    }
+
+    for(auto& column: m_columns)
+        column.reserve(blockRows);
+}
+
+Icom::TelemetryWriter::~TelemetryWriter()
+{
+    try
+    {
+        flush();
+    }
+    catch(...)
+    {}
+
+    const uint64_t used = reinterpret_cast<FileHeader*>(m_map)->used;
+    munmap(m_map, m_capacity);
+    if(ftruncate(m_fd, used)) {}
+    close(m_fd);
+}
+
+void Icom::TelemetryWriter::append(const int64_t time, const int64_t* fields)
+{
+    m_last = std::max(m_last, time);
+    m_columns[0].push_back(m_last);
+    for(unsigned int i=0; i<m_fields; ++i)
+        m_columns[i+1].push_back(fields[i]);
+
+    if(m_columns[0].size() >= m_blockRows)
+        flush();
+}
+
+void Icom::TelemetryWriter::flush()
+{
+    const size_t rows = m_columns[0].size();
+    if(rows == 0)
+        return;
+
+    // Worst case every value is its own run
+    reserve(sizeof(BlockHeader) + m_columns.size()*rows*2*maxVarint);
+
+    FileHeader& file = *reinterpret_cast<FileHeader*>(m_map);
+    uint8_t* const start = m_map + file.used;
+    uint8_t* data = start + sizeof(BlockHeader);
+
+    // Each column is a series of (difference, repeat count) pairs
+    for(const auto& column: m_columns)
+    {
+        int64_t previous = 0;
+        size_t i = 0;
+        while(i < rows)
+        {
+            const int64_t delta = column[i] - previous;
+            size_t run = 1;
+            while(i+run < rows && column[i+run]-column[i+run-1] == delta)
+                ++run;
+
+            data = putVarint(data, zigzag(delta));
+            data = putVarint(data, run);
+            previous = column[i+run-1];
+            i += run;
+        }
+    }
+
+    // Blocks aren't aligned so the header is copied in
+    BlockHeader block;
+    block.first = m_columns[0].front();
+    block.last = m_columns[0].back();
+    block.rows = rows;
+    block.size = data - start - sizeof(BlockHeader);
+    std::memcpy(start, &block, sizeof(block));
+
+    // Only now is the block part of the file
+    file.used = data - m_map;
+
+    for(auto& column: m_columns)
+        column.clear();
+}
+
+void Icom::TelemetryWriter::reserve(const size_t bytes)
+{
+    const size_t used = m_map
+        ? reinterpret_cast<const FileHeader*>(m_map)->used
+        : 0;
+    if(used + bytes <= m_capacity)
+        return;
+
+    const size_t capacity = std::max(
+            used + bytes,
+            m_capacity + std::max(m_capacity, growth));
+    if(ftruncate(m_fd, capacity))
+        throw CantOpenStore();
+
+    if(m_map)
+        munmap(m_map, m_capacity);
+    m_map = static_cast<uint8_t*>(mmap(
+            nullptr,
+            capacity,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            m_fd,
+            0));
+    if(m_map == MAP_FAILED)
+    {
+        m_map = nullptr;
+        m_capacity = 0;
+        throw CantOpenStore();
+    }
+    m_capacity = capacity;
+}
+
+Icom::TelemetryReader::TelemetryReader(const std::string& path):
+    m_rows(0),
+    m_map(nullptr),
+    m_size(0)
+{
+    m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(m_fd == -1)
+        throw CantOpenStore();
+
+    struct stat status;
+    if(fstat(m_fd, &status) == -1
+            || (size_t)status.st_size < sizeof(FileHeader))
+    {
+        close(m_fd);
+        throw InvalidStore();
+    }
+
+    m_size = status.st_size;
+    const void* const map = mmap(
+            nullptr,
+            m_size,
+            PROT_READ,
+            MAP_SHARED,
+            m_fd,
+            0);
+    if(map == MAP_FAILED)
+    {
+        close(m_fd);
+        throw CantOpenStore();
+    }
+    m_map = static_cast<const uint8_t*>(map);
+
+    const FileHeader& header = *reinterpret_cast<const FileHeader*>(m_map);
+    if(std::memcmp(header.magic, magic, sizeof(magic))
+            || header.used < sizeof(FileHeader)
+            || header.used > m_size)
+    {
+        munmap(const_cast<uint8_t*>(m_map), m_size);
+        close(m_fd);
+        throw InvalidStore();
+    }
+    m_fields = header.fields;
+
+    // Index the blocks by walking their headers. Every block must lie wholly
+    // within the used part of the file, the blocks must fill it exactly and
+    // they must be in time order for the index to be searchable.
+    size_t offset = sizeof(FileHeader);
+    while(offset < header.used)
+    {
+        BlockHeader block;
+        if(header.used - offset < sizeof(BlockHeader))
+            break;
+        std::memcpy(&block, m_map+offset, sizeof(block));
+        if(block.rows == 0
+                || block.first > block.last
+                || (!m_blocks.empty() && block.first < m_blocks.back().last)
+                || block.size > header.used - offset - sizeof(BlockHeader))
+            break;
+
+        m_blocks.push_back(Block{block.first, block.last, offset});
+        m_rows += block.rows;
+        offset += sizeof(BlockHeader) + block.size;
+    }
+    if(offset != header.used)
+    {
+        munmap(const_cast<uint8_t*>(m_map), m_size);
+        close(m_fd);
+        throw InvalidStore();
+    }
+}
+
+Icom::TelemetryReader::~TelemetryReader()
+{
+    munmap(const_cast<uint8_t*>(m_map), m_size);
+    close(m_fd);
+}
+
+void Icom::TelemetryReader::scan(
+        const int64_t from,
+        const int64_t to,
+        const Visitor& visit) const
+{
+    // First block that may hold rows at or after from
+    std::vector<Block>::const_iterator block = std::lower_bound(
+            m_blocks.begin(),
+            m_blocks.end(),
+            from,
+            [](const Block& block, const int64_t time)
+            {
+                return block.last < time;
+            });
+
+    std::vector<int64_t> columns;
+    std::vector<int64_t> row(m_fields);
+
+    for(; block != m_blocks.end() && block->first < to; ++block)
+    {
+        BlockHeader header;
+        std::memcpy(&header, m_map+block->offset, sizeof(header));
+        const uint8_t* data = m_map + block->offset + sizeof(BlockHeader);
+        const uint8_t* const end = data + header.size;
+        const size_t rows = header.rows;
+
+        // Decode the whole block column by column
+        columns.resize(rows*(m_fields+1));
+        for(unsigned int column=0; column<=m_fields; ++column)
+        {
+            int64_t* value = &columns[column*rows];
+            int64_t* const last = value + rows;
+            int64_t previous = 0;
+            while(value != last)
+            {
+                uint64_t delta;
+                uint64_t run;
+                data = getVarint(data, end, delta);
+                if(data == nullptr)
+                    throw InvalidStore();
+                data = getVarint(data, end, run);
+                if(data == nullptr || run > (size_t)(last-value))
+                    throw InvalidStore();
+
+                for(; run; --run)
+                {
+                    previous += unzigzag(delta);
+                    *value++ = previous;
+                }
+            }
+        }
+
+        for(size_t i=0; i<rows; ++i)
+        {
+            const int64_t time = columns[i];
+            if(time < from)
+                continue;
+            if(time >= to)
+                break;
+
+            for(unsigned int field=0; field<m_fields; ++field)
+                row[field] = columns[(field+1)*rows + i];
+            visit(time, row.data());
+        }
+    }
+}
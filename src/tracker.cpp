@@ -0,0 +1,188 @@
+/*!
+ * @file       tracker.cpp
+ * @brief      Defines the Icom::Tracker class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "libicom/tracker.hpp"
+#include "libicom/frequency.hpp"
+#include "libicom/plan.hpp"
+
+Icom::Tracker::Tracker(
+        const Controller& controller,
+        const device_t& device,
+        const Function& function,
+        const double threshold,
+        const unsigned int client):
+    m_controller(controller),
+    m_device(device),
+    m_function(function),
+    m_threshold(threshold),
+    m_client(client),
+    m_start(Clock::now()),
+    m_updates(0),
+    m_errors(0),
+    m_samples(0),
+    m_squaredError(0),
+    m_maxError(0),
+    m_running(true),
+    m_thread(&Tracker::run, this)
+{}
+
+Icom::Tracker::~Tracker()
+{
+    m_running = false;
+    m_thread.join();
+}
+
+Icom::Tracker::Function Icom::Tracker::interpolate(const Table& table)
+{
+    return [table](const Clock::time_point time) -> double
+    {
+        if(table.empty())
+            return 0;
+
+        const auto after = std::upper_bound(
+                table.cbegin(),
+                table.cend(),
+                time,
+                [](
+                    const Clock::time_point time,
+                    const Table::value_type& entry)
+                {
+                    return time < entry.first;
+                });
+        if(after == table.cbegin())
+            return after->second;
+        if(after == table.cend())
+            return table.back().second;
+
+        const auto before = after-1;
+        const double fraction =
+            std::chrono::duration<double>(time-before->first).count()
+            / std::chrono::duration<double>(after->first-before->first)
+            .count();
+        return before->second + (after->second-before->second)*fraction;
+    };
+}
+
+double Icom::Tracker::rate() const
+{
+    const double elapsed =
+        std::chrono::duration<double>(Clock::now()-m_start).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return elapsed>0 ? m_updates/elapsed : 0;
+}
+
+double Icom::Tracker::error() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples ? std::sqrt(m_squaredError/m_samples) : 0;
+}
+
+double Icom::Tracker::maxError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxError;
+}
+
+unsigned long Icom::Tracker::errors() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_errors;
+}
+
+const unsigned int Icom::Tracker::backoff;
+
+void Icom::Tracker::run()
+{
+    // An update takes effect once its frame is through
+    const Clock::duration frame =
+        m_controller.wireTime(FrequencyPlan::frameSize);
+
+    bool tuned = false;
+    double current = 0;
+    Clock::time_point through;
+    while(m_running)
+    {
+        // Wait out the budgets and the last frame before deciding what to
+        // send. Writing any sooner would only queue up in the port.
+        std::this_thread::sleep_until(std::max(
+                    through,
+                    m_controller.available(m_device, m_client)));
+
+        const Clock::time_point now = Clock::now();
+        const double wanted = std::min(
+                std::max(m_function(now+frame), 0.0),
+                (double)std::numeric_limits<unsigned int>::max());
+        if(std::isnan(wanted))
+        {
+            std::this_thread::sleep_for(frame);
+            continue;
+        }
+
+        if(tuned)
+        {
+            const double error = std::fabs(m_function(now)-current);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_samples;
+            m_squaredError += error*error;
+            m_maxError = std::max(m_maxError, error);
+        }
+
+        if(tuned && std::fabs(wanted-current) < m_threshold)
+        {
+            std::this_thread::sleep_for(frame);
+            continue;
+        }
+
+        const unsigned int frequency = (unsigned int)std::llround(wanted);
+        Command update(SetFrequency::make(m_device, frequency));
+        update->setClient(m_client);
+        try
+        {
+            m_controller.execute(update);
+        }
+        catch(...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_errors;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+            continue;
+        }
+
+        tuned = true;
+        current = frequency;
+        through = update->sent()+frame;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_updates;
+    }
+}
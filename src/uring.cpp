@@ -0,0 +1,181 @@
+/*!
+ * @file       uring.cpp
+ * @brief      Defines the Icom::Uring class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/uring.hpp"
+
+#ifdef ICOM_IO_URING
+
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+Icom::Uring::Uring(const unsigned int entries):
+    m_sq(MAP_FAILED),
+    m_cq(MAP_FAILED),
+    m_sqes(static_cast<io_uring_sqe*>(MAP_FAILED)),
+    m_queued(0)
+{
+    struct io_uring_params parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    m_fd = syscall(__NR_io_uring_setup, entries, &parameters);
+    if(m_fd < 0)
+        throw CantSetupRing();
+
+    m_sqSize = parameters.sq_off.array
+        + parameters.sq_entries*sizeof(unsigned int);
+    m_cqSize = parameters.cq_off.cqes
+        + parameters.cq_entries*sizeof(io_uring_cqe);
+    m_sqesSize = parameters.sq_entries*sizeof(io_uring_sqe);
+
+    m_sq = mmap(
+            nullptr,
+            m_sqSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            m_fd,
+            IORING_OFF_SQ_RING);
+    m_cq = mmap(
+            nullptr,
+            m_cqSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            m_fd,
+            IORING_OFF_CQ_RING);
+    m_sqes = static_cast<io_uring_sqe*>(mmap(
+            nullptr,
+            m_sqesSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            m_fd,
+            IORING_OFF_SQES));
+    if(m_sq == MAP_FAILED || m_cq == MAP_FAILED || m_sqes == MAP_FAILED)
+    {
+        release();
+        throw CantSetupRing();
+    }
+
+    char* const sq = static_cast<char*>(m_sq);
+    m_sqHead = reinterpret_cast<unsigned int*>(sq+parameters.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned int*>(sq+parameters.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned int*>(
+            sq+parameters.sq_off.ring_mask);
+    m_sqEntries = parameters.sq_entries;
+    m_sqArray = reinterpret_cast<unsigned int*>(sq+parameters.sq_off.array);
+
+    char* const cq = static_cast<char*>(m_cq);
+    m_cqHead = reinterpret_cast<unsigned int*>(cq+parameters.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned int*>(cq+parameters.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned int*>(
+            cq+parameters.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq+parameters.cq_off.cqes);
+}
+
+Icom::Uring::~Uring()
+{
+    release();
+}
+
+void Icom::Uring::release()
+{
+    if(m_sqes != MAP_FAILED)
+        munmap(m_sqes, m_sqesSize);
+    if(m_cq != MAP_FAILED)
+        munmap(m_cq, m_cqSize);
+    if(m_sq != MAP_FAILED)
+        munmap(m_sq, m_sqSize);
+    close(m_fd);
+}
+
+void Icom::Uring::prepare(
+        const uint8_t opcode,
+        const int fd,
+        const void* buffer,
+        const unsigned int length,
+        const uint64_t data,
+        const uint8_t flags)
+{
+    const unsigned int tail = *m_sqTail;
+    if(tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) == m_sqEntries)
+        enter(0);
+
+    const unsigned int index = tail & m_sqMask;
+    io_uring_sqe& entry = m_sqes[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.opcode = opcode;
+    entry.flags = flags;
+    entry.fd = fd;
+    entry.addr = reinterpret_cast<uint64_t>(buffer);
+    entry.len = length;
+    if(opcode == IORING_OP_READ || opcode == IORING_OP_WRITE)
+        entry.off = -1;  // Serial ports have no position
+    entry.user_data = data;
+
+    m_sqArray[index] = index;
+    __atomic_store_n(m_sqTail, tail+1, __ATOMIC_RELEASE);
+    ++m_queued;
+}
+
+void Icom::Uring::enter(const unsigned int wait)
+{
+    while(true)
+    {
+        const int submitted = syscall(
+                __NR_io_uring_enter,
+                m_fd,
+                m_queued,
+                wait,
+                wait ? IORING_ENTER_GETEVENTS : 0,
+                nullptr,
+                0);
+        if(submitted >= 0)
+        {
+            m_queued -= submitted;
+            if(m_queued == 0)
+                return;
+        }
+        else if(errno != EINTR)
+            throw EnterError();
+    }
+}
+
+bool Icom::Uring::reap(int& result, uint64_t& data)
+{
+    const unsigned int head = *m_cqHead;
+    if(head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+        return false;
+
+    const io_uring_cqe& entry = m_cqes[head & m_cqMask];
+    result = entry.res;
+    data = entry.user_data;
+    __atomic_store_n(m_cqHead, head+1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#endif
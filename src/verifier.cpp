@@ -0,0 +1,144 @@
+/*!
+ * @file       verifier.cpp
+ * @brief      Defines the Icom::Verifier class
+ * @author     Eddie Carle &lt;eddie@isatec.ca&gt;
+ * @date       October 19, 2026
+ * @copyright  Copyright &copy; 2015 %Isatec Inc.  This project is released
+ *             under the GNU General Public License Version 3.
+ */
+
+/* Copyright (C) 2015 %Isatec Inc.
+ *
+ * This file is part of the %Icom CI-V Control Library
+ *
+ * The %Icom CI-V Control Library is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * The %Icom CI-V Control Library is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * The %Icom CI-V Control Library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "libicom/verifier.hpp"
+#include "libicom/frequency.hpp"
+#include "libicom/mode.hpp"
+#include "libicom/duplex.hpp"
+
+namespace
+{
+    //! Was a value expected and not confirmed?
+    template<typename T> bool differs(
+            const Icom::Known<T>& expected,
+            const Icom::Known<T>& actual)
+    {
+        return expected.time != Icom::Clock::time_point()
+            && (actual.time == Icom::Clock::time_point()
+                    || actual.value != expected.value);
+    }
+}
+
+Icom::Verifier::Verifier(
+        const Controller& controller,
+        const Callback& mismatch,
+        const Clock::duration delay):
+    m_controller(controller),
+    m_mismatch(mismatch),
+    m_delay(delay),
+    m_running(true),
+    m_thread(&Verifier::run, this)
+{}
+
+Icom::Verifier::~Verifier()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void Icom::Verifier::execute(Commands& sets)
+{
+    for(auto& set: sets)
+        set->skipAcknowledgement();
+
+    m_controller.execute(sets);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(const auto& set: sets)
+        {
+            Expectation& expectation = m_expectations[set->device.address];
+            expectation.device = set->device;
+            set->update(expectation.state);
+        }
+        m_due = Clock::now()+m_delay;
+    }
+    m_wake.notify_one();
+}
+
+void Icom::Verifier::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+        // Wait until the sets have stopped coming for a while
+        if(m_running && m_expectations.empty())
+            m_wake.wait(lock);
+        else if(m_running && Clock::now() < m_due)
+            m_wake.wait_until(lock, m_due);
+        if(!m_running)
+            return;
+        if(m_expectations.empty() || Clock::now() < m_due)
+            continue;
+
+        Expectations expectations;
+        expectations.swap(m_expectations);
+        lock.unlock();
+
+        // Read back whatever was set on every device in one batch
+        Commands reads;
+        for(const auto& expectation: expectations)
+        {
+            const device_t& device = expectation.second.device;
+            const RadioState& state = expectation.second.state;
+            if(state.frequency.time != Clock::time_point())
+                reads.push_back(Command(GetFrequency::make(device)));
+            if(state.mode.time != Clock::time_point())
+                reads.push_back(Command(GetMode::make(device)));
+            if(state.offset.time != Clock::time_point())
+                reads.push_back(Command(GetDuplex::make(device)));
+        }
+
+        std::map<uint8_t, RadioState> actual;
+        try
+        {
+            m_controller.execute(reads);
+            for(const auto& read: reads)
+                if(read->status() == SUCCESS)
+                    read->update(actual[read->device.address]);
+        }
+        catch(...)
+        {}
+
+        for(const auto& expectation: expectations)
+        {
+            const RadioState& expected = expectation.second.state;
+            const RadioState& found = actual[expectation.first];
+            if(differs(expected.frequency, found.frequency)
+                    || differs(expected.mode, found.mode)
+                    || differs(expected.filter, found.filter)
+                    || differs(expected.offset, found.offset))
+                m_mismatch(expectation.second.device, expected, found);
+        }
+
+        lock.lock();
+    }
+}
@@ -26,6 +26,7 @@
  */
 
 #include "libicom/vfo.hpp"
+#include "libicom/state.hpp"
 
 Icom::VFO::VFO(const device_t& dev, vfoState_t state):
     Command_base(dev)
@@ -51,4 +52,43 @@ Icom::VFO::VFO(const device_t& dev):
     m_command.push_back(code);
 }
 
+void Icom::VFO::update(RadioState& state) const
+{
+    const Known<vfoState_t> vfo(state.vfo);
+    state.invalidate();
+
+    if(m_command.size() != 2)
+        return;
+
+    switch(m_command[1])
+    {
+        case VFOA:
+        case VFOB:
+            state.vfo.set((vfoState_t)m_command[1]);
+            break;
+
+        case SWAP:
+            if(vfo.time != Clock::time_point())
+                state.vfo.set(vfo.value==VFOA ? VFOB : VFOA);
+            break;
+
+        default:
+            state.vfo = vfo;
+    }
+}
+
+bool Icom::VFO::suppress(
+        const RadioState& state,
+        const Clock::duration maxAge)
+{
+    if(m_command.size() != 2
+            || (m_command[1] != VFOA && m_command[1] != VFOB)
+            || !state.vfo.confirmed(maxAge)
+            || state.vfo.value != (vfoState_t)m_command[1])
+        return false;
+
+    m_status = SUCCESS;
+    return true;
+}
+
 const uint8_t Icom::VFO::code;